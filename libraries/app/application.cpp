@@ -29,6 +29,7 @@
 #include <graphene/chain/db_with.hpp>
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 #include <graphene/protocol/types.hpp>
 
 #include <graphene/egenesis/egenesis.hpp>
@@ -44,6 +45,7 @@
 #include <fc/rpc/api_connection.hpp>
 #include <fc/rpc/websocket_api.hpp>
 #include <fc/network/resolve.hpp>
+#include <fc/thread/parallel.hpp>
 #include <fc/crypto/base64.hpp>
 
 #include <boost/filesystem/path.hpp>
@@ -77,6 +79,25 @@ namespace bpo = boost::program_options;
 
 namespace detail {
 
+   /**
+    * Parse a genesis state, the hash of the JSON is computed in parallel.
+    * @return the genesis state and the hash of json
+    */
+   std::pair<graphene::chain::genesis_state_type, fc::sha256> parse_genesis( const std::string& json )
+   {
+      auto hash = fc::do_parallel( [&json] () { return fc::sha256::hash( json ); } );
+      try
+      {
+         auto genesis = fc::json::from_string( json ).as<graphene::chain::genesis_state_type>( 20 );
+         return std::make_pair( std::move( genesis ), hash.wait() );
+      }
+      catch( ... )
+      {
+         hash.wait(); // json must outlive the task
+         throw;
+      }
+   }
+
    graphene::chain::genesis_state_type create_example_genesis() {
       auto nathan_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("nathan")));
       dlog("Allocating all stake to ${key}", ("key", utilities::key_to_wif(nathan_key)));
@@ -376,7 +397,8 @@ void application_impl::startup()
       {
          std::string genesis_str;
          fc::read_file_contents( _options->at("genesis-json").as<boost::filesystem::path>(), genesis_str );
-         graphene::chain::genesis_state_type genesis = fc::json::from_string( genesis_str ).as<graphene::chain::genesis_state_type>( 20 );
+         auto parsed = parse_genesis( genesis_str );
+         graphene::chain::genesis_state_type genesis = std::move( parsed.first );
          bool modified_genesis = false;
          if( _options->count("genesis-timestamp") )
          {
@@ -407,7 +429,7 @@ void application_impl::startup()
             genesis.initial_chain_id = fc::sha256::hash( genesis_str );
          }
          else
-            genesis.initial_chain_id = fc::sha256::hash( genesis_str );
+            genesis.initial_chain_id = parsed.second;
          return genesis;
       }
       else
@@ -415,9 +437,10 @@ void application_impl::startup()
          std::string egenesis_json;
          graphene::egenesis::compute_egenesis_json( egenesis_json );
          FC_ASSERT( egenesis_json != "" );
-         FC_ASSERT( graphene::egenesis::get_egenesis_json_hash() == fc::sha256::hash( egenesis_json ) );
-         auto genesis = fc::json::from_string( egenesis_json ).as<graphene::chain::genesis_state_type>( 20 );
-         genesis.initial_chain_id = fc::sha256::hash( egenesis_json );
+         auto parsed = parse_genesis( egenesis_json );
+         FC_ASSERT( graphene::egenesis::get_egenesis_json_hash() == parsed.second );
+         auto genesis = std::move( parsed.first );
+         genesis.initial_chain_id = parsed.second;
          return genesis;
       }
    };
@@ -443,6 +466,11 @@ void application_impl::startup()
       _chain_db->enable_standby_votes_tracking( _options->at("enable-standby-votes-tracking").as<bool>() );
    }
 
+   if( _options->count("signature-cache-size") )
+   {
+      graphene::protocol::signature_cache::instance().set_capacity( _options->at("signature-cache-size").as<uint64_t>() );
+   }
+
    if( _options->count("replay-blockchain") || _options->count("revalidate-blockchain") )
       _chain_db->wipe( _data_dir / "blockchain", false );
 
@@ -728,13 +756,21 @@ message application_impl::get_item(const item_id& id)
   // ilog("Request for item ${id}", ("id", id));
    if( id.item_type == graphene::net::block_message_type )
    {
-      auto opt_block = _chain_db->fetch_block_by_id(id.item_hash);
+      auto opt_block = _chain_db->fetch_block_view_by_id(id.item_hash);
       if( !opt_block )
          elog("Couldn't find block ${id} -- corresponding ID in our chain is ${id2}",
               ("id", id.item_hash)("id2", _chain_db->get_block_id_for_num(block_header::num_from_id(id.item_hash))));
       FC_ASSERT( opt_block.valid() );
       // ilog("Serving up block #${num}", ("num", opt_block->block_num()));
-      return block_message(std::move(*opt_block));
+      // a packed block_message is the packed block followed by its id, so the stored bytes can be sent as they are
+      message result;
+      result.msg_type = block_message::type;
+      result.data.reserve( opt_block->packed().size() + sizeof(block_id_type) );
+      result.data.insert( result.data.end(), opt_block->packed().begin(), opt_block->packed().end() );
+      const block_id_type& block_id = opt_block->id();
+      result.data.insert( result.data.end(), (const char*)&block_id, (const char*)&block_id + sizeof(block_id) );
+      result.size = (uint32_t)result.data.size();
+      return result;
    }
    return trx_message( _chain_db->get_recent_transaction( id.item_hash ) );
 } FC_CAPTURE_AND_RETHROW( (id) ) }
@@ -953,8 +989,8 @@ uint32_t application_impl::get_block_number(const item_hash_t& block_id)
  */
 fc::time_point_sec application_impl::get_block_time(const item_hash_t& block_id)
 { try {
-   auto opt_block = _chain_db->fetch_block_by_id( block_id );
-   if( opt_block.valid() ) return opt_block->timestamp;
+   auto opt_block = _chain_db->fetch_block_view_by_id( block_id );
+   if( opt_block.valid() ) return opt_block->header().timestamp;
    return fc::time_point_sec::min();
 } FC_CAPTURE_AND_RETHROW( (block_id) ) }
 
@@ -999,6 +1035,8 @@ application::~application()
    {
       my->_chain_db->close();
    }
+   const auto& sig_cache = graphene::protocol::signature_cache::instance();
+   ilog( "Signature cache: ${h} hits, ${m} misses", ("h",sig_cache.hits())("m",sig_cache.misses()) );
 }
 
 void application::set_program_options(boost::program_options::options_description& command_line_options,
@@ -1027,6 +1065,8 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("enable-standby-votes-tracking", bpo::value<bool>()->implicit_value(true),
           "Whether to enable tracking of votes of standby witnesses and committee members. "
           "Set it to true to provide accurate data to API clients, set to false for slightly better performance.")
+         ("signature-cache-size", bpo::value<uint64_t>()->default_value(graphene::protocol::signature_cache::default_capacity),
+          "Maximum number of public keys recovered from transaction signatures to keep for reuse, 0 to disable")
          ("api-limit-get-account-history-operations",boost::program_options::value<uint64_t>()->default_value(100),
           "For history_api::get_account_history_operations to set its default limit value as 100")
          ("api-limit-get-account-history",boost::program_options::value<uint64_t>()->default_value(100),
@@ -348,14 +348,28 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
          }
       }
 
+      /** enqueue the changed orders of one type, only the order types subscribers can be interested in are visited */
+      template<typename T>
+      void enqueue_changes_if_subscribed_to_market( const object_change_set& changes, object_change change,
+                                                    market_queue_type& queue, bool full_object )
+      {
+         const auto& ids = changes.ids( change );
+         const auto range = changes.ids( change, T::space_id, T::type_id );
+         for( auto itr = range.first; itr != range.second; ++itr )
+         {
+            const object* obj = ( change == object_change::removed ) ? changes.removed_objects()[ itr - ids.begin() ]
+                                                                     : _db.find_object( *itr );
+            enqueue_if_subscribed_to_market<T>( obj, queue, full_object );
+         }
+      }
+
       void broadcast_updates( const vector<variant>& updates );
       void broadcast_market_updates( const market_queue_type& queue);
-      void handle_object_changed(bool force_notify, bool full_object, const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts, std::function<const object*(object_id_type id)> find_object);
+      void handle_object_changed( bool force_notify, bool full_object, const object_change_set& changes,
+                                  object_change change );
 
       /** called every time a block is applied to report the objects that were changed */
-      void on_objects_new(const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts);
-      void on_objects_changed(const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts);
-      void on_objects_removed(const vector<object_id_type>& ids, const vector<const object*>& objs, const flat_set<account_id_type>& impacted_accounts);
+      void on_objects_changed( const object_change_set& changes );
       void on_applied_block();
 
       bool _notify_remove_create = false;
@@ -366,9 +380,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       std::function<void(const fc::variant&)> _block_applied_callback;
       bool _enabled_auto_subscription = true;
 
-      boost::signals2::scoped_connection                                                                                           _new_connection;
-      boost::signals2::scoped_connection                                                                                           _change_connection;
-      boost::signals2::scoped_connection                                                                                           _removed_connection;
+      boost::signals2::scoped_connection                                                                                           _object_changes_connection;
       boost::signals2::scoped_connection                                                                                           _applied_block_connection;
       boost::signals2::scoped_connection                                                                                           _pending_trx_connection;
       map< pair<asset_id_type,asset_id_type>, std::function<void(const variant&)> >      _market_subscriptions;
@@ -391,14 +403,8 @@ database_api_impl::database_api_impl( graphene::chain::database& db, const appli
 :_db(db), _app_options(app_options)
 {
    dlog("creating database api ${x}", ("x",int64_t(this)) );
-   _new_connection = _db.new_objects.connect([this](const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts) {
-                                on_objects_new(ids, impacted_accounts);
-                                });
-   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts) {
-                                on_objects_changed(ids, impacted_accounts);
-                                });
-   _removed_connection = _db.removed_objects.connect([this](const vector<object_id_type>& ids, const vector<const object*>& objs, const flat_set<account_id_type>& impacted_accounts) {
-                                on_objects_removed(ids, objs, impacted_accounts);
+   _object_changes_connection = _db.object_changes.connect([this](const object_change_set& changes) {
+                                on_objects_changed(changes);
                                 });
    _applied_block_connection = _db.applied_block.connect([this](const signed_block&){ on_applied_block(); });
 
@@ -600,9 +606,9 @@ optional<block_header> database_api::get_block_header(uint32_t block_num)const
 
 optional<block_header> database_api_impl::get_block_header(uint32_t block_num) const
 {
-   auto result = _db.fetch_block_by_number(block_num);
+   auto result = _db.fetch_block_view_by_number(block_num);
    if(result)
-      return *result;
+      return block_header( result->header() );
    return {};
 }
 map<uint32_t, optional<block_header>> database_api::get_block_header_batch(const vector<uint32_t> block_nums)const
@@ -646,10 +652,10 @@ optional<signed_transaction> database_api::get_recent_transaction_by_id( const t
 
 processed_transaction database_api_impl::get_transaction(uint32_t block_num, uint32_t trx_num)const
 {
-   auto opt_block = _db.fetch_block_by_number(block_num);
+   auto opt_block = _db.fetch_block_view_by_number(block_num);
    FC_ASSERT( opt_block );
-   FC_ASSERT( opt_block->transactions.size() > trx_num );
-   return opt_block->transactions[trx_num];
+   FC_ASSERT( opt_block->transaction_count() > trx_num );
+   return opt_block->transaction( trx_num );
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -2397,11 +2403,11 @@ vector< fc::variant > database_api::get_required_fees( const vector<operation>&
 struct get_required_fees_helper
 {
    get_required_fees_helper(
-      const fee_schedule& _current_fee_schedule,
+      const fee_table& _current_fee_table,
       const price& _core_exchange_rate,
       uint32_t _max_recursion
       )
-      : current_fee_schedule(_current_fee_schedule),
+      : current_fee_table(_current_fee_table),
         core_exchange_rate(_core_exchange_rate),
         max_recursion(_max_recursion)
    {}
@@ -2414,7 +2420,7 @@ struct get_required_fees_helper
       }
       else
       {
-         asset fee = current_fee_schedule.set_fee( op, core_exchange_rate );
+         asset fee = current_fee_table.set_fee( op, core_exchange_rate );
          fc::variant result;
          fc::to_variant( fee, result, GRAPHENE_NET_MAX_NESTED_OBJECTS );
          return result;
@@ -2434,13 +2440,13 @@ struct get_required_fees_helper
       }
       // we need to do this on the boxed version, which is why we use
       // two mutually recursive functions instead of a visitor
-      result.first = current_fee_schedule.set_fee( proposal_create_op, core_exchange_rate );
+      result.first = current_fee_table.set_fee( proposal_create_op, core_exchange_rate );
       fc::variant vresult;
       fc::to_variant( result, vresult, GRAPHENE_NET_MAX_NESTED_OBJECTS );
       return vresult;
    }
 
-   const fee_schedule& current_fee_schedule;
+   const fee_table& current_fee_table;
    const price& core_exchange_rate;
    uint32_t max_recursion;
    uint32_t current_recursion = 0;
@@ -2457,8 +2463,9 @@ vector< fc::variant > database_api_impl::get_required_fees( const vector<operati
    vector< fc::variant > result;
    result.reserve(ops.size());
    const asset_object& a = *get_asset_from_string(asset_id_or_symbol);
+   const auto fees = _db.get_shared_fee_table();
    get_required_fees_helper helper(
-      _db.current_fee_schedule(),
+      *fees,
       a.options.core_exchange_rate,
       GET_REQUIRED_FEES_MAX_RECURSION );
    for( operation& op : _ops )
@@ -2675,49 +2682,34 @@ void database_api_impl::broadcast_market_updates( const market_queue_type& queue
    }
 }
 
-void database_api_impl::on_objects_removed( const vector<object_id_type>& ids, const vector<const object*>& objs, const flat_set<account_id_type>& impacted_accounts)
-{
-   handle_object_changed(_notify_remove_create, false, ids, impacted_accounts,
-      [objs](object_id_type id) -> const object* {
-         auto it = std::find_if(
-               objs.begin(), objs.end(),
-               [id](const object* o) {return o != nullptr && o->id == id;});
-
-         if (it != objs.end())
-            return *it;
-
-         return nullptr;
-      }
-   );
-}
-
-void database_api_impl::on_objects_new(const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts)
+void database_api_impl::on_objects_changed( const object_change_set& changes )
 {
-   handle_object_changed(_notify_remove_create, true, ids, impacted_accounts,
-      std::bind(&object_database::find_object, &_db, std::placeholders::_1)
-   );
+   handle_object_changed( _notify_remove_create, true, changes, object_change::created );
+   handle_object_changed( false, true, changes, object_change::modified );
+   handle_object_changed( _notify_remove_create, false, changes, object_change::removed );
 }
 
-void database_api_impl::on_objects_changed(const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts)
+void database_api_impl::handle_object_changed( bool force_notify, bool full_object, const object_change_set& changes,
+                                               object_change change )
 {
-   handle_object_changed(false, true, ids, impacted_accounts,
-      std::bind(&object_database::find_object, &_db, std::placeholders::_1)
-   );
-}
+   const auto& ids = changes.ids( change );
+   if( ids.empty() )
+      return;
 
-void database_api_impl::handle_object_changed(bool force_notify, bool full_object, const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts, std::function<const object*(object_id_type id)> find_object)
-{
    if( _subscribe_callback )
    {
+      // the impacted accounts are only determined if they can make a difference
+      const bool impacted = !force_notify && !_subscribed_accounts.empty()
+                            && is_impacted_account( changes.impacted_accounts( change ) );
       vector<variant> updates;
 
-      for(auto id : ids)
+      for( const object_id_type& id : ids )
       {
-         if( force_notify || is_subscribed_to_item(id) || is_impacted_account(impacted_accounts) )
+         if( force_notify || is_subscribed_to_item(id) || impacted )
          {
             if( full_object )
             {
-               auto obj = find_object(id);
+               auto obj = _db.find_object(id);
                if( obj )
                {
                   updates.emplace_back( obj->to_variant() );
@@ -2738,21 +2730,9 @@ void database_api_impl::handle_object_changed(bool force_notify, bool full_objec
    {
       market_queue_type broadcast_queue;
 
-      for(auto id : ids)
-      {
-         if( id.is<call_order_object>() )
-         {
-            enqueue_if_subscribed_to_market<call_order_object>( find_object(id), broadcast_queue, full_object );
-         }
-         else if( id.is<limit_order_object>() )
-         {
-            enqueue_if_subscribed_to_market<limit_order_object>( find_object(id), broadcast_queue, full_object );
-         }
-         else if( id.is<force_settlement_object>() )
-         {
-            enqueue_if_subscribed_to_market<force_settlement_object>( find_object(id), broadcast_queue, full_object );
-         }
-      }
+      enqueue_changes_if_subscribed_to_market<call_order_object>( changes, change, broadcast_queue, full_object );
+      enqueue_changes_if_subscribed_to_market<limit_order_object>( changes, change, broadcast_queue, full_object );
+      enqueue_changes_if_subscribed_to_market<force_settlement_object>( changes, change, broadcast_queue, full_object );
 
       if( broadcast_queue.size() )
          broadcast_market_updates(broadcast_queue);
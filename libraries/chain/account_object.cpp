@@ -112,148 +112,73 @@ void account_statistics_object::pay_fee( share_type core_fee, share_type cashbac
       pending_vested_fees += core_fee;
 }
 
-set<account_id_type> account_member_index::get_account_members(const account_object& a)const
+void account_member_accounts::operator()( const account_object& a, vector<account_id_type>& members )const
 {
-   set<account_id_type> result;
-   for( auto auth : a.owner.account_auths )
-      result.insert(auth.first);
-   for( auto auth : a.active.account_auths )
-      result.insert(auth.first);
-   return result;
+   for( const auto& auth : a.owner.account_auths )
+      members.push_back( auth.first );
+   for( const auto& auth : a.active.account_auths )
+      members.push_back( auth.first );
 }
-set<public_key_type, pubkey_comparator> account_member_index::get_key_members(const account_object& a)const
+
+void account_member_keys::operator()( const account_object& a, vector<public_key_type>& members )const
 {
-   set<public_key_type, pubkey_comparator> result;
-   for( auto auth : a.owner.key_auths )
-      result.insert(auth.first);
-   for( auto auth : a.active.key_auths )
-      result.insert(auth.first);
-   result.insert( a.options.memo_key );
-   return result;
+   for( const auto& auth : a.owner.key_auths )
+      members.push_back( auth.first );
+   for( const auto& auth : a.active.key_auths )
+      members.push_back( auth.first );
+   members.push_back( a.options.memo_key );
 }
-set<address> account_member_index::get_address_members(const account_object& a)const
+
+void account_member_addresses::operator()( const account_object& a, vector<address>& members )const
 {
-   set<address> result;
-   for( auto auth : a.owner.address_auths )
-      result.insert(auth.first);
-   for( auto auth : a.active.address_auths )
-      result.insert(auth.first);
-   result.insert( a.options.memo_key );
-   return result;
+   for( const auto& auth : a.owner.address_auths )
+      members.push_back( auth.first );
+   for( const auto& auth : a.active.address_auths )
+      members.push_back( auth.first );
+   members.push_back( a.options.memo_key );
 }
 
 void account_member_index::object_inserted(const object& obj)
 {
-    assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
-    const account_object& a = static_cast<const account_object&>(obj);
-
-    auto account_members = get_account_members(a);
-    for( auto item : account_members )
-       account_to_account_memberships[item].insert(obj.id);
-
-    auto key_members = get_key_members(a);
-    for( auto item : key_members )
-       account_to_key_memberships[item].insert(obj.id);
-
-    auto address_members = get_address_members(a);
-    for( auto item : address_members )
-       account_to_address_memberships[item].insert(obj.id);
+   assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(obj);
+   account_members.inserted( a );
+   key_members.inserted( a );
+   address_members.inserted( a );
 }
 
 void account_member_index::object_removed(const object& obj)
 {
-    assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
-    const account_object& a = static_cast<const account_object&>(obj);
-
-    auto key_members = get_key_members(a);
-    for( auto item : key_members )
-       account_to_key_memberships[item].erase( obj.id );
-
-    auto address_members = get_address_members(a);
-    for( auto item : address_members )
-       account_to_address_memberships[item].erase( obj.id );
+   assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(obj);
+   key_members.removed( a );
+   address_members.removed( a );
+   account_members.removed( a );
+}
 
-    auto account_members = get_account_members(a);
-    for( auto item : account_members )
-       account_to_account_memberships[item].erase( obj.id );
+void account_member_index::rebuild( const index& primary )
+{
+   account_members.rebuild( primary );
+   key_members.rebuild( primary );
+   address_members.rebuild( primary );
 }
 
 void account_member_index::about_to_modify(const object& before)
 {
-   before_key_members.clear();
-   before_account_members.clear();
    assert( dynamic_cast<const account_object*>(&before) ); // for debug only
    const account_object& a = static_cast<const account_object&>(before);
-   before_key_members     = get_key_members(a);
-   before_address_members = get_address_members(a);
-   before_account_members = get_account_members(a);
+   key_members.about_to_modify( a );
+   address_members.about_to_modify( a );
+   account_members.about_to_modify( a );
 }
 
 void account_member_index::object_modified(const object& after)
 {
-    assert( dynamic_cast<const account_object*>(&after) ); // for debug only
-    const account_object& a = static_cast<const account_object&>(after);
-
-    {
-       set<account_id_type> after_account_members = get_account_members(a);
-       vector<account_id_type> removed; removed.reserve(before_account_members.size());
-       std::set_difference(before_account_members.begin(), before_account_members.end(),
-                           after_account_members.begin(), after_account_members.end(),
-                           std::inserter(removed, removed.end()));
-
-       for( auto itr = removed.begin(); itr != removed.end(); ++itr )
-          account_to_account_memberships[*itr].erase(after.id);
-
-       vector<object_id_type> added; added.reserve(after_account_members.size());
-       std::set_difference(after_account_members.begin(), after_account_members.end(),
-                           before_account_members.begin(), before_account_members.end(),
-                           std::inserter(added, added.end()));
-
-       for( auto itr = added.begin(); itr != added.end(); ++itr )
-          account_to_account_memberships[*itr].insert(after.id);
-    }
-
-
-    {
-       set<public_key_type, pubkey_comparator> after_key_members = get_key_members(a);
-
-       vector<public_key_type> removed; removed.reserve(before_key_members.size());
-       std::set_difference(before_key_members.begin(), before_key_members.end(),
-                           after_key_members.begin(), after_key_members.end(),
-                           std::inserter(removed, removed.end()));
-
-       for( auto itr = removed.begin(); itr != removed.end(); ++itr )
-          account_to_key_memberships[*itr].erase(after.id);
-
-       vector<public_key_type> added; added.reserve(after_key_members.size());
-       std::set_difference(after_key_members.begin(), after_key_members.end(),
-                           before_key_members.begin(), before_key_members.end(),
-                           std::inserter(added, added.end()));
-
-       for( auto itr = added.begin(); itr != added.end(); ++itr )
-          account_to_key_memberships[*itr].insert(after.id);
-    }
-
-    {
-       set<address> after_address_members = get_address_members(a);
-
-       vector<address> removed; removed.reserve(before_address_members.size());
-       std::set_difference(before_address_members.begin(), before_address_members.end(),
-                           after_address_members.begin(), after_address_members.end(),
-                           std::inserter(removed, removed.end()));
-
-       for( auto itr = removed.begin(); itr != removed.end(); ++itr )
-          account_to_address_memberships[*itr].erase(after.id);
-
-       vector<address> added; added.reserve(after_address_members.size());
-       std::set_difference(after_address_members.begin(), after_address_members.end(),
-                           before_address_members.begin(), before_address_members.end(),
-                           std::inserter(added, added.end()));
-
-       for( auto itr = added.begin(); itr != added.end(); ++itr )
-          account_to_address_memberships[*itr].insert(after.id);
-    }
-
+   assert( dynamic_cast<const account_object*>(&after) ); // for debug only
+   const account_object& a = static_cast<const account_object&>(after);
+   account_members.modified( a );
+   key_members.modified( a );
+   address_members.modified( a );
 }
 
 void account_referrer_index::object_inserted( const object& obj )
@@ -269,6 +194,46 @@ void account_referrer_index::object_modified( const object& after  )
 {
 }
 
+std::atomic<uint64_t> account_authority_version_index::next_version( 1 );
+
+void account_authority_version_index::new_version( object_id_type account )
+{
+   const auto instance = account.instance();
+   if( versions.size() <= instance )
+      versions.resize( instance + 1, 0 );
+   versions[instance] = next_version++;
+}
+
+uint64_t account_authority_version_index::get_version( account_id_type account )const
+{
+   const auto instance = account.instance.value;
+   return instance < versions.size() ? versions[instance] : 0;
+}
+
+void account_authority_version_index::object_inserted( const object& obj )
+{
+   new_version( obj.id );
+}
+
+void account_authority_version_index::object_removed( const object& obj )
+{
+   new_version( obj.id );
+}
+
+void account_authority_version_index::about_to_modify( const object& before )
+{
+   const account_object& a = static_cast<const account_object&>(before);
+   before_owner  = a.owner;
+   before_active = a.active;
+}
+
+void account_authority_version_index::object_modified( const object& after  )
+{
+   const account_object& a = static_cast<const account_object&>(after);
+   if( !( a.owner == before_owner ) || !( a.active == before_active ) )
+      new_version( after.id );
+}
+
 const uint8_t  balances_by_account_index::bits = 20;
 const uint64_t balances_by_account_index::mask = (1ULL << balances_by_account_index::bits) - 1;
 
@@ -149,28 +149,70 @@ block_id_type block_database::fetch_block_id( uint32_t block_num )const
    return e.block_id;
 }
 
-optional<signed_block> block_database::fetch_optional( const block_id_type& id )const
+optional<index_entry> block_database::read_index_entry( uint32_t block_num )const
+{
+   index_entry e;
+   int64_t index_pos = sizeof(e) * int64_t(block_num);
+   _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
+   if ( _block_num_to_pos.tellg() <= index_pos )
+      return {};
+
+   _block_num_to_pos.seekg( index_pos, _block_num_to_pos.beg );
+   _block_num_to_pos.read( (char*)&e, sizeof(e) );
+   return e;
+}
+
+signed_block_view block_database::read_block( const index_entry& e )const
+{
+   vector<char> data( e.block_size.value() );
+   _blocks.seekg( e.block_pos.value() );
+   if (e.block_size.value())
+      _blocks.read( data.data(), e.block_size.value() );
+   signed_block_view result( std::move(data) );
+   FC_ASSERT( result.id() == e.block_id );
+   return result;
+}
+
+optional<signed_block_view> block_database::fetch_view_optional( const block_id_type& id )const
 {
    try
    {
-      index_entry e;
-      int64_t index_pos = sizeof(e) * int64_t(block_header::num_from_id(id));
-      _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-      if ( _block_num_to_pos.tellg() <= index_pos )
-         return {};
-
-      _block_num_to_pos.seekg( index_pos );
-      _block_num_to_pos.read( (char*)&e, sizeof(e) );
+      optional<index_entry> e = read_index_entry( block_header::num_from_id(id) );
+      if( !e || e->block_id != id ) return optional<signed_block_view>();
+      return read_block( *e );
+   }
+   catch (const fc::exception&)
+   {
+   }
+   catch (const std::exception&)
+   {
+   }
+   return optional<signed_block_view>();
+}
 
-      if( e.block_id != id ) return optional<signed_block>();
+optional<signed_block_view> block_database::fetch_view_by_number( uint32_t block_num )const
+{
+   try
+   {
+      optional<index_entry> e = read_index_entry( block_num );
+      if( !e ) return optional<signed_block_view>();
+      return read_block( *e );
+   }
+   catch (const fc::exception&)
+   {
+   }
+   catch (const std::exception&)
+   {
+   }
+   return optional<signed_block_view>();
+}
 
-      vector<char> data( e.block_size.value() );
-      _blocks.seekg( e.block_pos.value() );
-      if (e.block_size.value())
-         _blocks.read( data.data(), e.block_size.value() );
-      auto result = fc::raw::unpack<signed_block>(data);
-      FC_ASSERT( result.id() == e.block_id );
-      return result;
+optional<signed_block> block_database::fetch_optional( const block_id_type& id )const
+{
+   try
+   {
+      optional<signed_block_view> view = fetch_view_optional( id );
+      if( view ) return view->block();
    }
    catch (const fc::exception&)
    {
@@ -185,21 +227,8 @@ optional<signed_block> block_database::fetch_by_number( uint32_t block_num )cons
 {
    try
    {
-      index_entry e;
-      int64_t index_pos = sizeof(e) * int64_t(block_num);
-      _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
-      if ( _block_num_to_pos.tellg() <= index_pos )
-         return {};
-
-      _block_num_to_pos.seekg( index_pos, _block_num_to_pos.beg );
-      _block_num_to_pos.read( (char*)&e, sizeof(e) );
-
-      vector<char> data( e.block_size.value() );
-      _blocks.seekg( e.block_pos.value() );
-      _blocks.read( data.data(), e.block_size.value() );
-      auto result = fc::raw::unpack<signed_block>(data);
-      FC_ASSERT( result.id() == e.block_id );
-      return result;
+      optional<signed_block_view> view = fetch_view_by_number( block_num );
+      if( view ) return view->block();
    }
    catch (const fc::exception&)
    {
@@ -238,7 +267,7 @@ optional<index_entry> block_database::last_index_entry()const {
                _blocks.read( data.data(), e.block_size.value() );
                if( _blocks.gcount() == long(e.block_size.value()) )
                {
-                  const signed_block block = fc::raw::unpack<signed_block>(data);
+                  const signed_block_view block( std::move(data) );
                   if( block.id() == e.block_id )
                      return e;
                }
@@ -41,6 +41,8 @@
 #include <fc/io/raw.hpp>
 #include <fc/thread/parallel.hpp>
 
+#include <algorithm>
+
 namespace graphene { namespace chain {
 
 bool database::is_known_block( const block_id_type& id )const
@@ -80,6 +82,23 @@ optional<signed_block> database::fetch_block_by_number( uint32_t num )const
       return _block_id_to_block.fetch_by_number(num);
 }
 
+optional<signed_block_view> database::fetch_block_view_by_id( const block_id_type& id )const
+{
+   auto b = _fork_db.fetch_block( id );
+   if( !b )
+      return _block_id_to_block.fetch_view_optional(id);
+   return signed_block_view( b->data );
+}
+
+optional<signed_block_view> database::fetch_block_view_by_number( uint32_t num )const
+{
+   auto results = _fork_db.fetch_block_by_number(num);
+   if( results.size() == 1 )
+      return signed_block_view( results[0]->data );
+   else
+      return _block_id_to_block.fetch_view_by_number(num);
+}
+
 const signed_transaction& database::get_recent_transaction(const transaction_id_type& trx_id) const
 {
    auto& index = get_index_type<transaction_index>().indices().get<by_trx_id>();
@@ -127,6 +146,26 @@ bool database::push_block(const signed_block& new_block, uint32_t skip)
    return result;
 }
 
+/// The checks which do not modify the state, they cannot fail when a block is applied again on top of the same
+/// ancestors, see fork_item::applied_skip_flags
+static const uint32_t skip_revalidation = database::skip_witness_signature | database::skip_transaction_signatures
+                                          | database::skip_merkle_check | database::skip_block_size_check
+                                          | database::skip_tapos_check | database::skip_witness_schedule_check;
+
+/// @return the skip flags to apply the block of the fork item with, skipping the checks which were done before
+static uint32_t fork_item_skip_flags( const fork_item& item, uint32_t skip )
+{
+   if( !item.applied_skip_flags.valid() )
+      return skip;
+   return skip | ( skip_revalidation & ~*item.applied_skip_flags );
+}
+
+/// Records that the block of the fork item was applied successfully, a check counts as done if any application did it
+static void set_fork_item_applied( fork_item& item, uint32_t skip )
+{
+   item.applied_skip_flags = item.applied_skip_flags.valid() ? ( *item.applied_skip_flags & skip ) : skip;
+}
+
 bool database::_push_block(const signed_block& new_block)
 { try {
    uint32_t skip = get_node_properties().skip_flags;
@@ -158,9 +197,11 @@ bool database::_push_block(const signed_block& new_block)
                optional<fc::exception> except;
                try {
                   undo_database::session session = _undo_db.start_undo_session();
-                  apply_block( (*ritr)->data, skip );
+                  const uint32_t item_skip = fork_item_skip_flags( **ritr, skip );
+                  apply_block( (*ritr)->data, item_skip );
                   _block_id_to_block.store( (*ritr)->id, (*ritr)->data );
                   session.commit();
+                  set_fork_item_applied( **ritr, item_skip );
                }
                catch ( const fc::exception& e ) { except = e; }
                if( except )
@@ -188,9 +229,11 @@ bool database::_push_block(const signed_block& new_block)
                   {
                      ilog( "pushing block #${n} ${id}", ("n",(*ritr2)->data.block_num())("id",(*ritr2)->id) );
                      auto session = _undo_db.start_undo_session();
-                     apply_block( (*ritr2)->data, skip );
+                     const uint32_t item_skip = fork_item_skip_flags( **ritr2, skip );
+                     apply_block( (*ritr2)->data, item_skip );
                      _block_id_to_block.store( (*ritr2)->id, (*ritr2)->data );
                      session.commit();
+                     set_fork_item_applied( **ritr2, item_skip );
                   }
                   throw *except;
                }
@@ -205,6 +248,8 @@ bool database::_push_block(const signed_block& new_block)
       apply_block(new_block, skip);
       _block_id_to_block.store(new_block.id(), new_block);
       session.commit();
+      if( new_head->id == new_block.id() )
+         set_fork_item_applied( *new_head, skip );
    } catch ( const fc::exception& e ) {
       elog("Failed to push new block:\n${e}", ("e", e.to_detail_string()));
       _fork_db.remove( new_block.id() );
@@ -236,6 +281,19 @@ processed_transaction database::push_transaction( const precomputable_transactio
 } FC_CAPTURE_AND_RETHROW( (trx) ) }
 
 processed_transaction database::_push_transaction( const precomputable_transaction& trx )
+{
+   return _push_transaction_to_pending( trx, nullptr );
+}
+
+processed_transaction database::_push_pending_transaction( const pending_transaction& ptx )
+{
+   if( ptx.authority_verified() && pending_authorities_unchanged( ptx ) )
+      return _push_transaction_to_pending( ptx.trx, &ptx );
+   return _push_transaction_to_pending( ptx.trx, nullptr );
+}
+
+processed_transaction database::_push_transaction_to_pending( const precomputable_transaction& trx,
+                                                              const pending_transaction* verified )
 {
    // If this is the first transaction pushed after applying a block, start a new undo session.
    // This allows us to quickly rewind to the clean state of the head block, in case a new block arrives.
@@ -248,8 +306,28 @@ processed_transaction database::_push_transaction( const precomputable_transacti
    // apply the changes.
 
    auto temp_session = _undo_db.start_undo_session();
-   auto processed_trx = _apply_transaction( trx );
-   _pending_tx.push_back(processed_trx);
+   const uint32_t skip = get_node_properties().skip_flags;
+   processed_transaction processed_trx;
+   flat_set<account_id_type> authority_accounts;
+   if( verified != nullptr )
+   {
+      // The signatures were checked against authorities which have not changed since, so only the
+      // state-dependent part of the transaction needs to be applied again
+      detail::with_skip_flags( *this, skip | skip_transaction_signatures, [&]()
+      {
+         processed_trx = _apply_transaction( trx );
+      });
+      authority_accounts = verified->authority_accounts;
+   }
+   else
+      processed_trx = _apply_transaction( trx, &authority_accounts );
+
+   auto inserted = _pending_tx.push_back( pending_transaction( processed_trx, skip, std::move(authority_accounts),
+                                                               get_global_properties().parameters.max_authority_depth,
+                                                               head_block_time() >= HARDFORK_CORE_584_TIME ) );
+   FC_ASSERT( inserted.second, "Transaction ${id} is already in the pending queue", ("id", trx.id()) );
+   _pending_tx_packed_size += inserted.first->packed_size;
+   _pending_tx_skip_flags |= skip;
 
    // notify_changed_objects();
    // The transaction applied successfully. Merge its changes into the pending block session.
@@ -353,19 +431,35 @@ signed_block database::_generate_block(
    FC_ASSERT( scheduled_witness == witness_id );
 
    //
-   // The following code throws away existing pending_tx_session and
+   // Pending transactions are evaluated against the head block state, exactly as
+   // they will be when the new block is applied.  As long as the pending state has
+   // been built by applying every pending transaction in order, without skipping
+   // more checks than we do now, and they all fit into a block, the pending
+   // transactions already are the candidate block and nothing has to be re-applied.
+   //
+   // Otherwise the following code throws away existing pending_tx_session and
    // rebuilds it by re-applying pending transactions.
    //
-   // This rebuild is necessary because pending transactions' validity
-   // and semantics may have changed since they were received, because
-   // time-based semantics are evaluated based on the current block
-   // time.  These changes can only be reflected in the database when
-   // the value of the "when" variable is known, which means we need to
-   // re-apply pending transactions in this method.
+   // This rebuild is necessary when some pending transactions have to be
+   // postponed because of the block size limit, when they were accepted with
+   // checks skipped that block production must not skip, or when the pending
+   // state has been rewound without clearing the queue (e.g. by pop_block()).
    //
 
+   static const size_t max_partial_block_header_size = fc::raw::pack_size( signed_block_header() )
+                                                       - fc::raw::pack_size( witness_id_type() ) // witness_id
+                                                       + 3; // max space to store size of transactions (out of block header),
+                                                            // +3 means 3*7=21 bits so it's practically safe
+   const size_t max_block_header_size = max_partial_block_header_size + fc::raw::pack_size( witness_id );
+   auto maximum_block_size = get_global_properties().parameters.maximum_block_size;
+   size_t total_block_size = max_block_header_size;
+
+   const bool pending_state_is_candidate = _pending_state_matches_queue
+                                           && ( _pending_tx_skip_flags & ~skip ) == 0
+                                           && total_block_size + _pending_tx_packed_size <= maximum_block_size;
+
    // pop pending state (reset to head block state)
-   _pending_tx_session.reset();
+   discard_pending_tx_session();
 
    // Check witness signing key
    if( !(skip & skip_witness_signature) )
@@ -378,39 +472,24 @@ signed_block database::_generate_block(
       FC_ASSERT( witness_id(*this).signing_key == block_signing_private_key.get_public_key() );
    }
 
-   static const size_t max_partial_block_header_size = fc::raw::pack_size( signed_block_header() )
-                                                       - fc::raw::pack_size( witness_id_type() ) // witness_id
-                                                       + 3; // max space to store size of transactions (out of block header),
-                                                            // +3 means 3*7=21 bits so it's practically safe
-   const size_t max_block_header_size = max_partial_block_header_size + fc::raw::pack_size( witness_id );
-   auto maximum_block_size = get_global_properties().parameters.maximum_block_size;
-   size_t total_block_size = max_block_header_size;
-
    signed_block pending_block;
 
-   _pending_tx_session = _undo_db.start_undo_session();
-
-   uint64_t postponed_tx_count = 0;
-   for( const processed_transaction& tx : _pending_tx )
+   if( pending_state_is_candidate )
    {
-      size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
-
-      // postpone transaction if it would make block too big
-      if( new_total_size > maximum_block_size )
-      {
-         postponed_tx_count++;
-         continue;
-      }
+      pending_block.transactions.reserve( _pending_tx.size() );
+      for( const pending_transaction& pending : _pending_tx )
+         pending_block.transactions.push_back( pending.trx );
+   }
+   else
+   {
+      _pending_tx_session = _undo_db.start_undo_session();
 
-      try
+      uint64_t postponed_tx_count = 0;
+      for( const pending_transaction& pending : _pending_tx )
       {
-         auto temp_session = _undo_db.start_undo_session();
-         processed_transaction ptx = _apply_transaction( tx );
+         const processed_transaction& tx = pending.trx;
+         size_t new_total_size = total_block_size + pending.packed_size;
 
-         // We have to recompute pack_size(ptx) because it may be different
-         // than pack_size(tx) (i.e. if one or more results increased
-         // their size)
-         new_total_size = total_block_size + fc::raw::pack_size( ptx );
          // postpone transaction if it would make block too big
          if( new_total_size > maximum_block_size )
          {
@@ -418,24 +497,41 @@ signed_block database::_generate_block(
             continue;
          }
 
-         temp_session.merge();
-
-         total_block_size = new_total_size;
-         pending_block.transactions.push_back( ptx );
+         try
+         {
+            auto temp_session = _undo_db.start_undo_session();
+            processed_transaction ptx = _apply_transaction( tx );
+
+            // We have to recompute pack_size(ptx) because it may be different
+            // than pack_size(tx) (i.e. if one or more results increased
+            // their size)
+            new_total_size = total_block_size + fc::raw::pack_size( ptx );
+            // postpone transaction if it would make block too big
+            if( new_total_size > maximum_block_size )
+            {
+               postponed_tx_count++;
+               continue;
+            }
+
+            temp_session.merge();
+
+            total_block_size = new_total_size;
+            pending_block.transactions.push_back( ptx );
+         }
+         catch ( const fc::exception& e )
+         {
+            // Do nothing, transaction will not be re-applied
+            wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
+            wlog( "The transaction was ${t}", ("t", tx) );
+         }
       }
-      catch ( const fc::exception& e )
+      if( postponed_tx_count > 0 )
       {
-         // Do nothing, transaction will not be re-applied
-         wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
-         wlog( "The transaction was ${t}", ("t", tx) );
+         wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
       }
-   }
-   if( postponed_tx_count > 0 )
-   {
-      wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
-   }
 
-   _pending_tx_session.reset();
+      _pending_tx_session.reset();
+   }
 
    // We have temporarily broken the invariant that
    // _pending_tx_session is the result of applying _pending_tx, as
@@ -462,7 +558,7 @@ signed_block database::_generate_block(
  */
 void database::pop_block()
 { try {
-   _pending_tx_session.reset();
+   discard_pending_tx_session();
    auto fork_db_head = _fork_db.head();
    FC_ASSERT( fork_db_head, "Trying to pop() from empty fork database!?" );
    if( fork_db_head->id == head_block_id() )
@@ -472,7 +568,12 @@ void database::pop_block()
       fork_db_head = _fork_db.fetch_block( head_block_id() );
       FC_ASSERT( fork_db_head, "Trying to pop() block that's not in fork database!?" );
    }
+   if( _undo_db.enabled() && _undo_db.size() > 0 )
+      record_authority_changes( _undo_db.head() );
+   else
+      _pending_authorities_all_changed = true;
    pop_undo();
+   update_witness_schedule_table();
    _popped_tx.insert( _popped_tx.begin(), fork_db_head->data.transactions.begin(), fork_db_head->data.transactions.end() );
 } FC_CAPTURE_AND_RETHROW() }
 
@@ -480,9 +581,84 @@ void database::clear_pending()
 { try {
    assert( (_pending_tx.size() == 0) || _pending_tx_session.valid() );
    _pending_tx.clear();
-   _pending_tx_session.reset();
+   _pending_tx_packed_size = 0;
+   _pending_tx_skip_flags = skip_nothing;
+   discard_pending_tx_session();
+   _pending_state_matches_queue = true;
 } FC_CAPTURE_AND_RETHROW() }
 
+bool pending_transaction::authority_verified()const
+{
+   return !( skip_flags & database::skip_transaction_signatures );
+}
+
+void database::discard_pending_tx_session()
+{
+   if( _pending_tx_session.valid() )
+   {
+      // the pending transactions may have been validated against changes which are about to be undone
+      if( _undo_db.enabled() && _undo_db.size() > 0 )
+         record_authority_changes( _undo_db.head() );
+      else
+         _pending_authorities_all_changed = true;
+   }
+   _pending_tx_session.reset();
+   if( !_pending_tx.empty() )
+      _pending_state_matches_queue = false;
+}
+
+void database::record_authority_changes( const undo_state& changes )
+{
+   for( const object_id_type& id : changes.new_ids )
+      if( id.is<account_id_type>() )
+         _pending_authority_changes.insert( account_id_type( id ) );
+   for( const auto& item : changes.removed )
+      if( item.first.is<account_id_type>() )
+         _pending_authority_changes.insert( account_id_type( item.first ) );
+   for( const auto& item : changes.old_values )
+   {
+      if( !item.first.is<account_id_type>() )
+         continue;
+      const account_id_type id( item.first );
+      const account_object& old_account = static_cast<const account_object&>( *item.second );
+      const account_object* account = find( id );
+      if( account == nullptr || !( account->owner == old_account.owner ) || !( account->active == old_account.active ) )
+         _pending_authority_changes.insert( id );
+   }
+}
+
+bool database::pending_authorities_unchanged( const pending_transaction& ptx )const
+{
+   if( _pending_authorities_all_changed || !_undo_db.enabled() )
+      return false;
+   if( ptx.max_authority_depth != get_global_properties().parameters.max_authority_depth
+         || ptx.allow_non_immediate_owner != ( head_block_time() >= HARDFORK_CORE_584_TIME ) )
+      return false;
+   // changes made by the transactions that have already been re-applied to the pending state
+   const undo_state* pending_changes = ( _pending_tx_session.valid() && _undo_db.size() > 0 ) ? &_undo_db.head()
+                                                                                             : nullptr;
+   for( const account_id_type& id : ptx.authority_accounts )
+   {
+      if( _pending_authority_changes.find( id ) != _pending_authority_changes.end() )
+         return false;
+      if( pending_changes != nullptr )
+      {
+         const object_id_type oid( id );
+         if( pending_changes->old_values.find( oid ) != pending_changes->old_values.end()
+               || pending_changes->new_ids.find( oid ) != pending_changes->new_ids.end()
+               || pending_changes->removed.find( oid ) != pending_changes->removed.end() )
+            return false;
+      }
+   }
+   return true;
+}
+
+void database::reset_pending_authority_changes()
+{
+   _pending_authority_changes.clear();
+   _pending_authorities_all_changed = false;
+}
+
 uint32_t database::push_applied_operation( const operation& op )
 {
    _applied_ops.emplace_back(op);
@@ -608,6 +784,12 @@ void database::_apply_block( const signed_block& next_block )
    if( !_node_property_object.debug_updates.empty() )
       apply_debug_updates();
 
+   // pending transactions will be revalidated against the new state
+   if( _undo_db.enabled() && _undo_db.size() > 0 )
+      record_authority_changes( _undo_db.head() );
+   else
+      _pending_authorities_all_changed = true;
+
    // notify observers that the block has been applied
    notify_applied_block( next_block ); //emit
    _applied_ops.clear();
@@ -627,11 +809,15 @@ processed_transaction database::apply_transaction(const signed_transaction& trx,
    return result;
 }
 
-processed_transaction database::_apply_transaction(const signed_transaction& trx)
+processed_transaction database::_apply_transaction( const signed_transaction& trx,
+                                                    flat_set<account_id_type>* authority_accounts )
 { try {
    uint32_t skip = get_node_properties().skip_flags;
 
-   trx.validate();
+   if( _operation_profiler.is_enabled() )
+      _operation_profiler.validate( trx );
+   else
+      trx.validate();
 
    auto& trx_idx = get_mutable_index_type<transaction_index>();
    const chain_id_type& chain_id = get_chain_id();
@@ -644,13 +830,22 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    if( !(skip & skip_transaction_signatures) )
    {
       bool allow_non_immediate_owner = ( head_block_time() >= HARDFORK_CORE_584_TIME );
-      auto get_active = [&]( account_id_type id ) { return &id(*this).active; };
-      auto get_owner  = [&]( account_id_type id ) { return &id(*this).owner;  };
+      auto get_active = [this,authority_accounts]( account_id_type id ) {
+         if( authority_accounts != nullptr )
+            authority_accounts->insert( id );
+         return &id(*this).active;
+      };
+      auto get_owner  = [this,authority_accounts]( account_id_type id ) {
+         if( authority_accounts != nullptr )
+            authority_accounts->insert( id );
+         return &id(*this).owner;
+      };
       trx.verify_authority( chain_id,
                             get_active,
                             get_owner,
                             allow_non_immediate_owner,
-                            get_global_properties().parameters.max_authority_depth );
+                            get_global_properties().parameters.max_authority_depth,
+                            &_authority_cache );
    }
 
    //Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
@@ -709,9 +904,40 @@ operation_result database::apply_operation(transaction_evaluation_state& eval_st
    FC_ASSERT( u_which < _operation_evaluators.size(), "No registered evaluator for operation ${op}", ("op",op) );
    unique_ptr<op_evaluator>& eval = _operation_evaluators[ u_which ];
    FC_ASSERT( eval, "No registered evaluator for operation ${op}", ("op",op) );
-   auto op_id = push_applied_operation( op );
-   auto result = eval->evaluate( eval_state, op, true );
-   set_applied_operation_result( op_id, result );
+   if( !_operation_profiler.is_enabled() )
+   {
+      auto op_id = push_applied_operation( op );
+      auto result = eval->evaluate( eval_state, op, true );
+      set_applied_operation_result( op_id, result );
+      return result;
+   }
+
+   operation_profiler::sample sample;
+   const object_change_counts changes_before = get_object_change_counts();
+   const auto start = operation_profiler::clock::now();
+   operation_result result;
+   eval_state.profile_sample = &sample;
+   try
+   {
+      auto op_id = push_applied_operation( op );
+      result = eval->evaluate( eval_state, op, true );
+      set_applied_operation_result( op_id, result );
+   }
+   catch( ... )
+   {
+      eval_state.profile_sample = nullptr;
+      _operation_profiler.record_failure( i_which );
+      throw;
+   }
+   eval_state.profile_sample = nullptr;
+   sample.times[operation_profiler::total_stage] = operation_profiler::elapsed( start );
+
+   const object_change_counts& changes_after = get_object_change_counts();
+   object_change_counts changes;
+   changes.created = changes_after.created - changes_before.created;
+   changes.modified = changes_after.modified - changes_before.modified;
+   changes.removed = changes_after.removed - changes_before.removed;
+   _operation_profiler.record( i_which, sample, changes );
    return result;
 } FC_CAPTURE_AND_RETHROW( (op) ) }
 
@@ -761,39 +987,107 @@ bool database::before_last_checkpoint()const
 static const uint32_t skip_expensive = database::skip_transaction_signatures | database::skip_witness_signature
                                        | database::skip_merkle_check | database::skip_transaction_dupe_check;
 
+/**
+ * Estimates the cost of validating an operation, in units of an ordinary operation. Confidential transfers check
+ * the sums of their Pedersen commitments and the headers of their range proofs, which costs far more.
+ */
+struct validation_weight_visitor
+{
+   typedef uint64_t result_type;
+
+   static const uint64_t commitment_weight = 64;
+
+   template<typename Op>
+   uint64_t operator()( const Op& )const { return 1; }
+
+   uint64_t operator()( const transfer_to_blind_operation& op )const
+   { return commitment_weight * ( 1 + op.outputs.size() ); }
+   uint64_t operator()( const transfer_from_blind_operation& op )const
+   { return commitment_weight * ( 1 + op.inputs.size() ); }
+   uint64_t operator()( const blind_transfer_operation& op )const
+   { return commitment_weight * ( 1 + op.inputs.size() + op.outputs.size() ); }
+};
+
 template<typename Trx>
 void database::_precompute_parallel( const Trx* trx, const size_t count, const uint32_t skip )const
 {
+   // Recovering the signature keys packs each transaction once to get its id and packed size as well.
+   // Without signatures to check, the ids are hashed in batches instead.
+   if( !(skip&skip_transaction_dupe_check) && (skip&skip_transaction_signatures) && count > 1 )
+   {
+      vector<const precomputable_transaction*> trxs( count );
+      for( size_t i = 0; i < count; ++i )
+         trxs[i] = trx + i;
+      precomputable_transaction::precompute_ids( trxs.data(), count );
+   }
    for( size_t i = 0; i < count; ++i, ++trx )
    {
-      trx->validate(); // TODO - parallelize wrt confidential operations
+      trx->validate(); // the result is kept by the transaction, so applying it does not validate again
+      if( !(skip&skip_transaction_signatures) )
+         trx->get_signature_keys( get_chain_id() );
       if ( !(skip & skip_block_size_check) )
          trx->get_packed_size();
       if( !(skip&skip_transaction_dupe_check) )
          trx->id();
-      if( !(skip&skip_transaction_signatures) )
-         trx->get_signature_keys( get_chain_id() );
    }
 }
 
+vector<size_t> database::precompute_chunks( const signed_block& block, const uint32_t skip, const uint32_t threads )
+{
+   vector<size_t> chunk_ends;
+   const size_t count = block.transactions.size();
+   if( count == 0 )
+      return chunk_ends;
+
+   // cost[i] is the validation weight of the transactions before the i-th one
+   vector<uint64_t> cost( count + 1, 0 );
+   bool expensive_validation = false;
+   for( size_t i = 0; i < count; ++i )
+   {
+      uint64_t weight = 0;
+      for( const operation& op : block.transactions[i].operations )
+         weight += op.visit( validation_weight_visitor() );
+      expensive_validation |= ( weight > block.transactions[i].operations.size() );
+      cost[i+1] = cost[i] + weight;
+   }
+
+   // Confidential transfers are worth validating in parallel even if nothing else is, e.g. during a replay
+   if( (skip & skip_expensive) == skip_expensive && !expensive_validation )
+      return chunk_ends;
+
+   // split the transactions into chunks of similar validation cost rather than of similar size
+   const uint32_t chunks = std::max( 1u, threads );
+   const uint64_t chunk_cost = ( cost[count] + chunks - 1 ) / chunks;
+   chunk_ends.reserve( 2 * chunks );
+   for( size_t base = 0; base < count; base = chunk_ends.back() )
+   {
+      size_t end = std::upper_bound( cost.begin() + base + 1, cost.end(), cost[base] + chunk_cost )
+                   - cost.begin() - 1;
+      chunk_ends.push_back( std::max( end, base + 1 ) );
+   }
+   return chunk_ends;
+}
+
 fc::future<void> database::precompute_parallel( const signed_block& block, const uint32_t skip )const
 { try {
    std::vector<fc::future<void>> workers;
    if( !block.transactions.empty() )
    {
-      if( (skip & skip_expensive) == skip_expensive )
+      const vector<size_t> chunk_ends = precompute_chunks( block, skip,
+                                                           fc::asio::default_io_service_scope::get_num_threads() );
+      if( chunk_ends.empty() )
          _precompute_parallel( &block.transactions[0], block.transactions.size(), skip );
       else
       {
-         uint32_t chunks = fc::asio::default_io_service_scope::get_num_threads();
-         uint32_t chunk_size = ( block.transactions.size() + chunks - 1 ) / chunks;
-         workers.reserve( chunks + 1 );
-         for( size_t base = 0; base < block.transactions.size(); base += chunk_size )
-            workers.push_back( fc::do_parallel( [this,&block,base,chunk_size,skip] () {
-               _precompute_parallel( &block.transactions[base],
-                                     base + chunk_size < block.transactions.size() ? chunk_size : block.transactions.size() - base,
-                                     skip );
+         workers.reserve( chunk_ends.size() + 1 );
+         size_t base = 0;
+         for( const size_t end : chunk_ends )
+         {
+            workers.push_back( fc::do_parallel( [this,&block,base,end,skip] () {
+               _precompute_parallel( &block.transactions[base], end - base, skip );
             }) );
+            base = end;
+         }
       }
    }
 
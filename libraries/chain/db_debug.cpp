@@ -189,6 +189,8 @@ void database::apply_debug_updates()
       return;
    for( const fc::variant_object& update : it->second )
       debug_apply_update( *this, update );
+   // the updates may have changed the schedule or the signing keys
+   update_witness_schedule_table();
 }
 
 void database::debug_update( const fc::variant_object& update )
@@ -24,6 +24,7 @@
 
 #include <graphene/chain/database.hpp>
 
+#include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
 #include <graphene/chain/chain_property_object.hpp>
 #include <graphene/chain/global_property_object.hpp>
@@ -60,6 +61,21 @@ const fee_schedule&  database::current_fee_schedule()const
    return get_global_properties().parameters.get_current_fees();
 }
 
+const fee_table& database::current_fee_table()const
+{
+   return _fee_table_cache->get_table();
+}
+
+std::shared_ptr<const fee_table> database::get_shared_fee_table()const
+{
+   return _fee_table_cache->get_shared_table();
+}
+
+uint64_t database::get_account_authority_version( account_id_type account )const
+{
+   return _account_authority_versions->get_version( account );
+}
+
 time_point_sec database::head_block_time()const
 {
    return get_dynamic_global_properties().time;
@@ -187,12 +187,17 @@ void database::initialize_indexes()
    _undo_db.set_max_size( GRAPHENE_MIN_UNDO_HISTORY );
 
    //Protocol object indexes
-   add_index< primary_index<asset_index, 13> >(); // 8192 assets per chunk
+   auto asset_idx = add_index< primary_index<asset_index, 13> >(); // 8192 assets per chunk
+   auto asset_authorizations = asset_idx->add_secondary_index<asset_authorization_index>();
+   _asset_authorizations = asset_authorizations;
    add_index< primary_index<force_settlement_index> >();
 
    auto acnt_index = add_index< primary_index<account_index, 20> >(); // ~1 million accounts per chunk
    acnt_index->add_secondary_index<account_member_index>();
    acnt_index->add_secondary_index<account_referrer_index>();
+   _account_authority_versions = acnt_index->add_secondary_index<account_authority_version_index>();
+   acnt_index->add_secondary_index<account_listing_observer>( asset_authorizations );
+   _authority_cache.clear();
 
    add_index< primary_index<committee_member_index, 8> >(); // 256 members per chunk
    add_index< primary_index<witness_index, 10> >(); // 1024 witnesses per chunk
@@ -201,6 +206,7 @@ void database::initialize_indexes()
 
    auto prop_index = add_index< primary_index<proposal_index > >();
    prop_index->add_secondary_index<required_approval_index>();
+   _proposal_authorizations = prop_index->add_secondary_index<proposal_authorization_index>();
 
    add_index< primary_index<withdraw_permission_index > >();
    add_index< primary_index<vesting_balance_index> >();
@@ -216,7 +222,8 @@ void database::initialize_indexes()
    bal_idx->add_secondary_index<balances_by_account_index>();
 
    add_index< primary_index<asset_bitasset_data_index,                 13 > >(); // 8192
-   add_index< primary_index<simple_index<global_property_object          >> >();
+   auto gpo_index = add_index< primary_index<simple_index<global_property_object          >> >();
+   _fee_table_cache = gpo_index->add_secondary_index<fee_table_cache>();
    add_index< primary_index<simple_index<dynamic_global_property_object  >> >();
    add_index< primary_index<account_stats_index,                       20 > >(); // 1 Mi
    add_index< primary_index<simple_index<asset_dynamic_data_object       >> >();
@@ -441,6 +448,9 @@ void database::init_genesis(const genesis_state_type& genesis_state)
    for (uint32_t i = 0; i <= 0x10000; i++)
       create<block_summary_object>( [&]( block_summary_object&) {});
 
+   // Secondary indexes which are not needed to build the genesis state are rebuilt once at the end
+   bulk_load_guard bulk_load( *this );
+
    // Create initial accounts
    for( const auto& account : genesis_state.initial_accounts )
    {
@@ -732,6 +742,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
 
    //debug_dump();
 
+   bulk_load.end();
    _undo_db.enable();
 } FC_CAPTURE_AND_RETHROW() }
 
@@ -595,11 +595,21 @@ void update_top_n_authorities( database& db )
                 break;
          }
 
+         // without holders the account keeps its authority, and it is only modified when its top holders or
+         // their weights changed, which saves undo records and the updates of the indexes of account authorities
+         if( vc.is_empty() )
+            return;
+         authority top_n_auth;
+         vc.finish( top_n_auth );
+         const uint8_t control_flag = is_owner ? account_object::top_n_control_owner
+                                               : account_object::top_n_control_active;
+         if( (acct.top_n_control_flags & control_flag) && (is_owner ? acct.owner : acct.active) == top_n_auth )
+            return;
+
          db.modify( acct, [&]( account_object& a )
          {
-            vc.finish( is_owner ? a.owner : a.active );
-            if( !vc.is_empty() )
-               a.top_n_control_flags |= (is_owner ? account_object::top_n_control_owner : account_object::top_n_control_active);
+            (is_owner ? a.owner : a.active) = top_n_auth;
+            a.top_n_control_flags |= control_flag;
          } );
       }
    } );
@@ -42,6 +42,7 @@
 namespace graphene { namespace chain {
 
 database::database()
+   : _authority_cache( [this]( account_id_type id ) { return _account_authority_versions->get_version( id ); } )
 {
    initialize_indexes();
    initialize_evaluators();
@@ -158,6 +159,8 @@ void database::reindex( fc::path data_dir )
    _undo_db.enable();
    auto end = fc::time_point::now();
    ilog( "Done reindexing, elapsed time: ${t} sec", ("t",double((end-start).count())/1000000.0 ) );
+   if( _operation_profiler.is_enabled() )
+      _operation_profiler.log_profile();
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
 void database::wipe(const fc::path& data_dir, bool include_blocks)
@@ -220,6 +223,7 @@ void database::open(
                     ("last_block->id", last_block)("head_block_id",head_block_num()) );
          reindex( data_dir );
       }
+      update_witness_schedule_table();
       _opened = true;
    }
    FC_CAPTURE_LOG_AND_RETHROW( (data_dir) )
@@ -3,6 +3,7 @@
 #include <graphene/protocol/authority.hpp>
 #include <graphene/protocol/operations.hpp>
 #include <graphene/protocol/transaction.hpp>
+#include <graphene/protocol/variant_dispatch.hpp>
 
 #include <graphene/chain/withdraw_permission_object.hpp>
 #include <graphene/chain/database.hpp>
@@ -17,6 +18,7 @@
 #include <graphene/chain/vesting_balance_object.hpp>
 #include <graphene/chain/transaction_history_object.hpp>
 #include <graphene/chain/impacted.hpp>
+#include <graphene/chain/object_change_set.hpp>
 
 using namespace fc;
 using namespace graphene::chain;
@@ -286,7 +288,7 @@ struct get_impacted_account_visitor
 void graphene::chain::operation_get_impacted_accounts( const operation& op, flat_set<account_id_type>& result )
 {
   get_impacted_account_visitor vtor = get_impacted_account_visitor( result );
-  op.visit( vtor );
+  graphene::protocol::dispatch( op, vtor );
 }
 
 void graphene::chain::transaction_get_impacted_accounts( const transaction& tx, flat_set<account_id_type>& result )
@@ -453,62 +455,110 @@ void database::notify_on_pending_transaction( const signed_transaction& tx )
    GRAPHENE_TRY_NOTIFY( on_pending_transaction, tx )
 }
 
-void database::notify_changed_objects()
-{ try {
-   if( _undo_db.enabled() ) 
+template<typename Map>
+static void sorted_values( const Map& values, vector<object_id_type>& ids, vector<const object*>& objects )
+{
+   vector< std::pair<object_id_type, const object*> > items;
+   items.reserve( values.size() );
+   for( const auto& item : values )
+      items.emplace_back( item.first, item.second.get() );
+   std::sort( items.begin(), items.end(),
+              []( const std::pair<object_id_type, const object*>& a, const std::pair<object_id_type, const object*>& b )
+              { return a.first < b.first; } );
+   ids.reserve( items.size() );
+   objects.reserve( items.size() );
+   for( const auto& item : items )
+   {
+      ids.push_back( item.first );
+      objects.push_back( item.second );
+   }
+}
+
+object_change_set::object_change_set( const object_database& db, const graphene::db::undo_state& state )
+   : _db( db )
+{
+   _created.ids.assign( state.new_ids.begin(), state.new_ids.end() );
+   std::sort( _created.ids.begin(), _created.ids.end() );
+   // new objects are looked up only if their impacted accounts are needed
+   _created.objects.resize( _created.ids.size(), nullptr );
+   // the impacted accounts of modified objects are derived from their previous values
+   sorted_values( state.old_values, _modified.ids, _modified.objects );
+   sorted_values( state.removed, _removed.ids, _removed.objects );
+}
+
+const object_change_set::changes& object_change_set::get( object_change change )const
+{
+   switch( change )
    {
-      const auto& head_undo = _undo_db.head();
+      case object_change::created:
+         return _created;
+      case object_change::modified:
+         return _modified;
+      default:
+         return _removed;
+   }
+}
 
-      // New
-      if( !new_objects.empty() )
-      {
-        vector<object_id_type> new_ids;  new_ids.reserve(head_undo.new_ids.size());
-        flat_set<account_id_type> new_accounts_impacted;
-        for( const auto& item : head_undo.new_ids )
-        {
-          new_ids.push_back(item);
-          auto obj = find_object(item);
-          if(obj != nullptr)
-            get_relevant_accounts(obj, new_accounts_impacted);
-        }
+object_change_set::id_range object_change_set::ids( object_change change, uint8_t space, uint8_t type )const
+{
+   const auto& ids = get( change ).ids;
+   return std::equal_range( ids.begin(), ids.end(), object_id_type( space, type, 0 ),
+                            []( const object_id_type& a, const object_id_type& b ) {
+                               return std::make_pair( a.space(), a.type() ) < std::make_pair( b.space(), b.type() );
+                            } );
+}
 
-        if( new_ids.size() )
-           GRAPHENE_TRY_NOTIFY( new_objects, new_ids, new_accounts_impacted)
+const flat_set<account_id_type>& object_change_set::impacted_accounts( object_change change )const
+{
+   const changes& c = get( change );
+   if( !c.accounts.valid() )
+   {
+      // collect the accounts of each object separately, then merge them at once
+      vector<account_id_type> all_accounts;
+      flat_set<account_id_type> accounts;
+      for( size_t i = 0; i < c.ids.size(); ++i )
+      {
+         const object* obj = c.objects[i] != nullptr ? c.objects[i] : _db.find_object( c.ids[i] );
+         if( obj == nullptr )
+            continue;
+         accounts.clear();
+         get_relevant_accounts( obj, accounts );
+         all_accounts.insert( all_accounts.end(), accounts.begin(), accounts.end() );
       }
+      std::sort( all_accounts.begin(), all_accounts.end() );
+      all_accounts.erase( std::unique( all_accounts.begin(), all_accounts.end() ), all_accounts.end() );
+      c.accounts = flat_set<account_id_type>( boost::container::ordered_unique_range,
+                                              all_accounts.begin(), all_accounts.end() );
+   }
+   return *c.accounts;
+}
 
-      // Changed
-      if( !changed_objects.empty() )
-      {
-        vector<object_id_type> changed_ids;  changed_ids.reserve(head_undo.old_values.size());
-        flat_set<account_id_type> changed_accounts_impacted;
-        for( const auto& item : head_undo.old_values )
-        {
-          changed_ids.push_back(item.first);
-          get_relevant_accounts(item.second.get(), changed_accounts_impacted);
-        }
+void database::notify_changed_objects()
+{ try {
+   if( !_undo_db.enabled() )
+      return;
+   // nothing is collected unless someone listens
+   if( object_changes.empty() && new_objects.empty() && changed_objects.empty() && removed_objects.empty() )
+      return;
 
-        if( changed_ids.size() )
-           GRAPHENE_TRY_NOTIFY( changed_objects, changed_ids, changed_accounts_impacted)
-      }
+   const object_change_set changes( *this, _undo_db.head() );
+   if( changes.empty() )
+      return;
 
-      // Removed
-      if( !removed_objects.empty() )
-      {
-        vector<object_id_type> removed_ids; removed_ids.reserve( head_undo.removed.size() );
-        vector<const object*> removed; removed.reserve( head_undo.removed.size() );
-        flat_set<account_id_type> removed_accounts_impacted;
-        for( const auto& item : head_undo.removed )
-        {
-          removed_ids.emplace_back( item.first );
-          auto obj = item.second.get();
-          removed.emplace_back( obj );
-          get_relevant_accounts(obj, removed_accounts_impacted);
-        }
+   GRAPHENE_TRY_NOTIFY( object_changes, changes )
 
-        if( removed_ids.size() )
-           GRAPHENE_TRY_NOTIFY( removed_objects, removed_ids, removed, removed_accounts_impacted)
-      }
-   }
+   const auto& new_ids = changes.ids( object_change::created );
+   if( !new_objects.empty() && !new_ids.empty() )
+      GRAPHENE_TRY_NOTIFY( new_objects, new_ids, changes.impacted_accounts( object_change::created ) )
+
+   const auto& changed_ids = changes.ids( object_change::modified );
+   if( !changed_objects.empty() && !changed_ids.empty() )
+      GRAPHENE_TRY_NOTIFY( changed_objects, changed_ids, changes.impacted_accounts( object_change::modified ) )
+
+   const auto& removed_ids = changes.ids( object_change::removed );
+   if( !removed_objects.empty() && !removed_ids.empty() )
+      GRAPHENE_TRY_NOTIFY( removed_objects, removed_ids, changes.removed_objects(),
+                           changes.impacted_accounts( object_change::removed ) )
 } FC_CAPTURE_AND_LOG( (0) ) }
 
 } }
@@ -31,7 +31,88 @@ namespace graphene { namespace chain {
 
 using boost::container::flat_set;
 
+const witness_schedule_table::slot& witness_schedule_table::get_slot( uint32_t slot_num )const
+{
+   // slot 0 is the last slot of the previous round
+   return slots[ ( uint64_t(slot_num) + slots.size() - 1 ) % slots.size() ];
+}
+
+witness_id_type witness_schedule_table::get_scheduled_witness( uint32_t slot_num )const
+{
+   return get_slot( slot_num ).witness;
+}
+
+const public_key_type& witness_schedule_table::get_scheduled_signing_key( uint32_t slot_num )const
+{
+   return get_slot( slot_num ).signing_key;
+}
+
+fc::time_point_sec witness_schedule_table::get_slot_time( uint32_t slot_num )const
+{
+   if( slot_num == 0 )
+      return fc::time_point_sec();
+   if( slot_num <= slots.size() )
+      return slots[ slot_num - 1 ].time;
+   return slots.front().time + ( slot_num - 1 ) * block_interval;
+}
+
+uint32_t witness_schedule_table::get_slot_at_time( fc::time_point_sec when )const
+{
+   fc::time_point_sec first_slot_time = slots.front().time;
+   if( when < first_slot_time )
+      return 0;
+   return (when - first_slot_time).to_seconds() / block_interval + 1;
+}
+
+const witness_schedule_table* database::current_witness_schedule_table()const
+{
+   if( _witness_schedule_table && _witness_schedule_table->head_block_id == head_block_id() )
+      return _witness_schedule_table.get();
+   return nullptr;
+}
+
+std::shared_ptr<const witness_schedule_table> database::get_witness_schedule_table()const
+{
+   auto result = std::atomic_load( &_witness_schedule_table );
+   // The table is rebuilt while a block is applied, before the block is committed. If the block is undone
+   // afterwards, e.g. because a plugin failed to process it, the table is stale until the next block.
+   if( result && result->head_block_id != head_block_id() )
+      result = build_witness_schedule_table();
+   FC_ASSERT( result, "The witness schedule has not been initialized" );
+   return result;
+}
+
+void database::update_witness_schedule_table()
+{
+   std::atomic_store( &_witness_schedule_table, build_witness_schedule_table() );
+}
+
+std::shared_ptr<const witness_schedule_table> database::build_witness_schedule_table()const
+{
+   const witness_schedule_object& wso = get_witness_schedule_object();
+   if( wso.current_shuffled_witnesses.empty() )
+      return std::shared_ptr<const witness_schedule_table>();
+
+   auto table = std::make_shared<witness_schedule_table>();
+   table->head_block_id = head_block_id();
+   table->block_interval = block_interval();
+   table->slots.reserve( wso.current_shuffled_witnesses.size() );
+   for( uint32_t slot_num = 1; slot_num <= wso.current_shuffled_witnesses.size(); ++slot_num )
+   {
+      witness_id_type witness = compute_scheduled_witness( slot_num );
+      table->slots.push_back( { compute_slot_time( slot_num ), witness, witness(*this).signing_key } );
+   }
+   return table;
+}
+
 witness_id_type database::get_scheduled_witness( uint32_t slot_num )const
+{
+   if( const witness_schedule_table* table = current_witness_schedule_table() )
+      return table->get_scheduled_witness( slot_num );
+   return compute_scheduled_witness( slot_num );
+}
+
+witness_id_type database::compute_scheduled_witness( uint32_t slot_num )const
 {
    const dynamic_global_property_object& dpo = get_dynamic_global_properties();
    const witness_schedule_object& wso = get_witness_schedule_object();
@@ -40,6 +121,13 @@ witness_id_type database::get_scheduled_witness( uint32_t slot_num )const
 }
 
 fc::time_point_sec database::get_slot_time(uint32_t slot_num)const
+{
+   if( const witness_schedule_table* table = current_witness_schedule_table() )
+      return table->get_slot_time( slot_num );
+   return compute_slot_time( slot_num );
+}
+
+fc::time_point_sec database::compute_slot_time(uint32_t slot_num)const
 {
    if( slot_num == 0 )
       return fc::time_point_sec();
@@ -71,7 +159,9 @@ fc::time_point_sec database::get_slot_time(uint32_t slot_num)const
 
 uint32_t database::get_slot_at_time(fc::time_point_sec when)const
 {
-   fc::time_point_sec first_slot_time = get_slot_time( 1 );
+   if( const witness_schedule_table* table = current_witness_schedule_table() )
+      return table->get_slot_at_time( when );
+   fc::time_point_sec first_slot_time = compute_slot_time( 1 );
    if( when < first_slot_time )
       return 0;
    return (when - first_slot_time).to_seconds() / block_interval() + 1;
@@ -132,6 +222,8 @@ void database::update_witness_schedule()
          }
       });
    }
+
+   update_witness_schedule_table();
 }
 
 } }
@@ -43,6 +43,7 @@ database& generic_evaluator::db()const { return trx_state->db(); }
    operation_result generic_evaluator::start_evaluate( transaction_evaluation_state& eval_state, const operation& op, bool apply )
    { try {
       trx_state   = &eval_state;
+      profile_sample = eval_state.profile_sample;
       //check_required_authorities(op);
       auto result = evaluate( op );
 
@@ -121,7 +122,7 @@ database& generic_evaluator::db()const { return trx_state->db(); }
 
    share_type generic_evaluator::calculate_fee_for_operation(const operation& op) const
    {
-     return db().current_fee_schedule().calculate_fee( op ).amount;
+     return db().current_fee_table().calculate_fee( op ).amount;
    }
    void generic_evaluator::db_adjust_balance(const account_id_type& fee_payer, asset fee_from_account)
    {
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/global_property_object.hpp>
+
+#include <graphene/protocol/fee_schedule.hpp>
+
+namespace graphene { namespace chain {
+
+void fee_table_cache::rebuild( const object& obj )
+{
+   const auto& gpo = static_cast<const global_property_object&>( obj );
+   std::atomic_store( &table, std::shared_ptr<const fee_table>(
+                                 std::make_shared<fee_table>( gpo.parameters.get_current_fees() ) ) );
+}
+
+void fee_table_cache::object_inserted( const object& obj )
+{
+   rebuild( obj );
+}
+
+void fee_table_cache::object_removed( const object& obj )
+{
+   std::atomic_store( &table, std::shared_ptr<const fee_table>() );
+}
+
+void fee_table_cache::object_modified( const object& after )
+{
+   rebuild( after );
+}
+
+const fee_table& fee_table_cache::get_table()const
+{
+   FC_ASSERT( table, "The global properties have not been initialized" );
+   return *table;
+}
+
+std::shared_ptr<const fee_table> fee_table_cache::get_shared_table()const
+{
+   auto result = std::atomic_load( &table );
+   FC_ASSERT( result, "The global properties have not been initialized" );
+   return result;
+}
+
+} } // graphene::chain
@@ -25,10 +25,13 @@
 
 #include <graphene/chain/types.hpp>
 #include <graphene/db/generic_index.hpp>
+#include <graphene/db/reference_tracker.hpp>
 #include <graphene/protocol/account.hpp>
 
 #include <boost/multi_index/composite_key.hpp>
 
+#include <atomic>
+
 namespace graphene { namespace chain {
    class database;
    class account_object;
@@ -293,6 +296,27 @@ namespace graphene { namespace chain {
          account_id_type get_id()const { return id; }
    };
 
+   /** The accounts in the owner and active authorities of an account */
+   struct account_member_accounts
+   {
+      typedef account_id_type key_type;
+      void operator()( const account_object& a, vector<account_id_type>& members )const;
+   };
+
+   /** The keys in the owner and active authorities of an account, and its memo key */
+   struct account_member_keys
+   {
+      typedef public_key_type key_type;
+      void operator()( const account_object& a, vector<public_key_type>& members )const;
+   };
+
+   /** The addresses in the owner and active authorities of an account, and the address of its memo key */
+   struct account_member_addresses
+   {
+      typedef address key_type;
+      void operator()( const account_object& a, vector<address>& members )const;
+   };
+
    /**
     *  @brief This secondary index will allow a reverse lookup of all accounts that a particular key or account
     *  is an potential signing authority.
@@ -305,22 +329,23 @@ namespace graphene { namespace chain {
          virtual void about_to_modify( const object& before ) override;
          virtual void object_modified( const object& after  ) override;
 
+         virtual bool supports_bulk_load()const override { return true; }
+         virtual void rebuild( const index& primary ) override;
 
          /** given an account or key, map it to the set of accounts that reference it in an active or owner authority */
-         map< account_id_type, set<account_id_type> >                    account_to_account_memberships;
-         map< public_key_type, set<account_id_type>, pubkey_comparator > account_to_key_memberships;
+         reference_map< account_id_type, account_id_type >                    account_to_account_memberships;
+         reference_map< public_key_type, account_id_type, pubkey_comparator > account_to_key_memberships;
          /** some accounts use address authorities in the genesis block */
-         map< address, set<account_id_type> >                            account_to_address_memberships;
-
-
-      protected:
-         set<account_id_type>                    get_account_members( const account_object& a )const;
-         set<public_key_type, pubkey_comparator> get_key_members( const account_object& a )const;
-         set<address>                            get_address_members( const account_object& a )const;
+         reference_map< address, account_id_type >                            account_to_address_memberships;
 
-         set<account_id_type>                    before_account_members;
-         set<public_key_type, pubkey_comparator> before_key_members;
-         set<address>                            before_address_members;
+      private:
+         // keys stay in the maps once they have been referenced
+         reference_tracker< account_object, account_id_type, account_member_accounts >
+               account_members { account_to_account_memberships, false };
+         reference_tracker< account_object, account_id_type, account_member_keys, pubkey_comparator >
+               key_members { account_to_key_memberships, false };
+         reference_tracker< account_object, account_id_type, account_member_addresses >
+               address_members { account_to_address_memberships, false };
    };
 
 
@@ -340,6 +365,35 @@ namespace graphene { namespace chain {
          map< account_id_type, set<account_id_type> > referred_by;
    };
 
+   /**
+    *  @brief This secondary index assigns a version number to the authorities of every account.
+    *
+    *  The version changes every time the owner or active authority of an account changes, including when the change
+    *  is undone, so that results derived from the authorities can be cached and validated cheaply. Version numbers
+    *  are never reused within a process.
+    */
+   class account_authority_version_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// @return the current version of the authorities of the account, 0 if the account does not exist
+         uint64_t get_version( account_id_type account )const;
+
+      private:
+         void new_version( object_id_type account );
+
+         static std::atomic<uint64_t> next_version;
+
+         /** Maps account instances to versions */
+         vector< uint64_t >           versions;
+         authority                    before_owner;
+         authority                    before_active;
+   };
+
    /**
     *  @brief This secondary index will allow fast access to the balance objects
     *         that belonging to an account.
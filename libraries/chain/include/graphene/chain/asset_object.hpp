@@ -27,6 +27,7 @@
 #include <graphene/protocol/asset_ops.hpp>
 
 #include <boost/multi_index/composite_key.hpp>
+#include <unordered_map>
 
 /**
  * @defgroup prediction_market Prediction Market
@@ -39,6 +40,7 @@
  */
 
 namespace graphene { namespace chain {
+   class account_object;
    class asset_bitasset_data_object;
    class database;
    using namespace graphene::db;
@@ -317,6 +319,58 @@ namespace graphene { namespace chain {
    > asset_object_multi_index_type;
    typedef generic_index<asset_object, asset_object_multi_index_type> asset_index;
 
+   /**
+    *  @brief This secondary index caches whether accounts pass the whitelist and blacklist authorities of assets
+    *
+    *  A verdict is dropped whenever the authorities of its asset or the whitelisting or blacklisting accounts of its
+    *  account change, including when such a change is undone, so a cached verdict always matches the current lists.
+    *  The allowed assets of an account are not covered, they are checked directly by @ref is_authorized_asset.
+    */
+   class asset_authorization_index : public secondary_index
+   {
+      public:
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// @return true if the account is not blacklisted by, and if required whitelisted by, the authorities of the asset
+         bool is_listed_authorized( const account_object& acct, const asset_object& asset_obj )const;
+
+         /// Drops the verdicts of an account, to be called when its whitelisting or blacklisting accounts change
+         void account_lists_changed( account_id_type account );
+
+         /// @return the number of cached verdicts
+         size_t size()const;
+
+      private:
+         static bool check( const account_object& acct, const asset_object& asset_obj );
+
+         /** Maps asset instances to the verdicts by account instance */
+         mutable vector< std::unordered_map< uint64_t, bool > > verdicts;
+         flat_set<account_id_type>                              before_whitelist;
+         flat_set<account_id_type>                              before_blacklist;
+   };
+
+   /**
+    *  @brief This secondary index of the accounts notifies an @ref asset_authorization_index when the whitelisting or
+    *  blacklisting accounts of an account change
+    */
+   class account_listing_observer : public secondary_index
+   {
+      public:
+         explicit account_listing_observer( asset_authorization_index* authorizations )
+            : _authorizations( authorizations ) {}
+
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+      private:
+         asset_authorization_index* _authorizations;
+         flat_set<account_id_type>  before_whitelisting;
+         flat_set<account_id_type>  before_blacklisting;
+   };
+
 } } // graphene::chain
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::asset_object)
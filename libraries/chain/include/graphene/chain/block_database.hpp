@@ -46,12 +46,19 @@ namespace graphene { namespace chain {
          block_id_type          fetch_block_id( uint32_t block_num )const;
          optional<signed_block> fetch_optional( const block_id_type& id )const;
          optional<signed_block> fetch_by_number( uint32_t block_num )const;
+         /// Like fetch_optional() and fetch_by_number(), without decoding the transactions of the block
+         ///@{
+         optional<signed_block_view> fetch_view_optional( const block_id_type& id )const;
+         optional<signed_block_view> fetch_view_by_number( uint32_t block_num )const;
+         ///@}
          optional<signed_block> last()const;
          optional<block_id_type> last_id()const;
          size_t                 blocks_current_position()const;
          size_t                 total_block_size()const;
       private:
          optional<index_entry> last_index_entry()const;
+         optional<index_entry> read_index_entry( uint32_t block_num )const;
+         signed_block_view     read_block( const index_entry& e )const;
          fc::path _index_filename;
          mutable std::fstream _blocks;
          mutable std::fstream _block_num_to_pos;
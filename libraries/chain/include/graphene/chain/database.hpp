@@ -23,6 +23,7 @@
  */
 #pragma once
 
+#include <graphene/protocol/authority_cache.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
 
 #include <graphene/chain/global_property_object.hpp>
@@ -32,7 +33,10 @@
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_database.hpp>
 #include <graphene/chain/genesis_state.hpp>
+#include <graphene/chain/object_change_set.hpp>
+#include <graphene/chain/pending_transactions.hpp>
 #include <graphene/chain/evaluator.hpp>
+#include <graphene/chain/operation_profiler.hpp>
 
 #include <graphene/db/object_database.hpp>
 #include <graphene/db/object.hpp>
@@ -49,9 +53,11 @@ namespace graphene { namespace chain {
    class op_evaluator;
    class transaction_evaluation_state;
    class proposal_object;
+   class proposal_authorization_index;
    class operation_history_object;
    class chain_property_object;
    class witness_schedule_object;
+   class witness_schedule_table;
    class witness_object;
    class force_settlement_object;
    class limit_order_object;
@@ -133,8 +139,15 @@ namespace graphene { namespace chain {
          block_id_type              get_block_id_for_num( uint32_t block_num )const;
          optional<signed_block>     fetch_block_by_id( const block_id_type& id )const;
          optional<signed_block>     fetch_block_by_number( uint32_t num )const;
+         /// Fetch a block without decoding its transactions, see @ref signed_block_view
+         ///@{
+         optional<signed_block_view> fetch_block_view_by_id( const block_id_type& id )const;
+         optional<signed_block_view> fetch_block_view_by_number( uint32_t num )const;
+         ///@}
          const signed_transaction&  get_recent_transaction( const transaction_id_type& trx_id )const;
          std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
+         /// The recent blocks, including those on forks which are not applied
+         const fork_database&       get_fork_database()const { return _fork_db; }
 
          /**
           *  Calculate the percent of block production slots that were missed in the
@@ -150,6 +163,11 @@ namespace graphene { namespace chain {
          processed_transaction push_transaction( const precomputable_transaction& trx, uint32_t skip = skip_nothing );
          bool _push_block( const signed_block& b );
          processed_transaction _push_transaction( const precomputable_transaction& trx );
+         /**
+          * Re-applies a transaction that was in the pending queue before the head block changed. The authority
+          * check is skipped if none of the accounts consulted by its last check has changed since.
+          */
+         processed_transaction _push_pending_transaction( const pending_transaction& ptx );
 
          ///@throws fc::exception if the proposed transaction fails to apply.
          processed_transaction push_proposal( const proposal_object& proposal );
@@ -168,6 +186,8 @@ namespace graphene { namespace chain {
 
          void pop_block();
          void clear_pending();
+         /// Forget the authority changes recorded for revalidation of pending transactions
+         void reset_pending_authority_changes();
 
          /**
           *  This method is used to track appied operations during the evaluation of a block, these
@@ -200,6 +220,13 @@ namespace graphene { namespace chain {
           */
          fc::signal<void(const signed_transaction&)>     on_pending_transaction;
 
+         /**
+          *  Emitted after a block has been applied and committed, with all objects the block created, modified
+          *  or removed. Listeners only pay for the object types and impacted accounts they ask the change set for.
+          *  The callback should not yield and should execute quickly.
+          */
+         fc::signal<void(const object_change_set&)> object_changes;
+
          /**
           *  Emitted After a block has been applied and committed.  The callback
           *  should not yield and should execute quickly.
@@ -255,6 +282,12 @@ namespace graphene { namespace chain {
           */
          uint32_t get_slot_at_time(fc::time_point_sec when)const;
 
+         /**
+          * @return the witness schedule as of the head block, which remains valid while the caller holds it;
+          *         to be called by the thread applying blocks, the result may be passed to other threads
+          */
+         std::shared_ptr<const witness_schedule_table> get_witness_schedule_table()const;
+
          void update_witness_schedule();
 
          //////////////////// db_getter.cpp ////////////////////
@@ -267,6 +300,10 @@ namespace graphene { namespace chain {
          const dynamic_global_property_object&  get_dynamic_global_properties()const;
          const node_property_object&            get_node_properties()const;
          const fee_schedule&                    current_fee_schedule()const;
+         /// The current fee schedule flattened for fast lookups, only to be used by the thread applying blocks
+         const fee_table&                       current_fee_table()const;
+         /// The current fee schedule flattened for fast lookups, for use outside of the thread applying blocks
+         std::shared_ptr<const fee_table>       get_shared_fee_table()const;
          const account_statistics_object&       get_account_stats_by_owner( account_id_type owner )const;
          const witness_schedule_object&         get_witness_schedule_object()const;
 
@@ -279,6 +316,18 @@ namespace graphene { namespace chain {
 
          node_property_object& node_properties();
 
+         /// Cache of authorization outcomes used when verifying transaction signatures
+         authority_cache& get_authority_cache() { return _authority_cache; }
+         /// @return the version of the owner and active authorities of an account, see account_authority_version_index
+         uint64_t get_account_authority_version( account_id_type account )const;
+         /// The remembered authorization outcomes of the proposals
+         proposal_authorization_index& get_proposal_authorizations() { return *_proposal_authorizations; }
+         /// The cached verdicts of the whitelist and blacklist authorities of the assets, see is_authorized_asset()
+         const asset_authorization_index& get_asset_authorizations()const { return *_asset_authorizations; }
+         /// Statistics of the evaluation of operations by type and stage, disabled by default
+         operation_profiler& get_operation_profiler() { return _operation_profiler; }
+         const operation_profiler& get_operation_profiler()const { return _operation_profiler; }
+
 
          uint32_t last_non_undoable_block_num() const;
          //////////////////// db_init.cpp ////////////////////
@@ -446,7 +495,8 @@ namespace graphene { namespace chain {
 
          /** Precomputes digests, signatures and operation validations depending
           *  on skip flags. "Expensive" computations may be done in a parallel
-          *  thread.
+          *  thread. Operations which are costly to validate, like confidential
+          *  transfers, are always validated in parallel threads.
           *
           * @param block the block to preprocess
           * @param skip indicates which computations can be skipped
@@ -463,6 +513,18 @@ namespace graphene { namespace chain {
           *         precomputations applied
           */
          fc::future<void> precompute_parallel( const precomputable_transaction& trx )const;
+
+         /** Splits the transactions of a block into chunks of similar validation
+          *  cost, each of which is precomputed by one worker thread.
+          *
+          * @param block the block to preprocess
+          * @param skip indicates which computations can be skipped
+          * @param threads the number of worker threads
+          * @return the end index of each chunk, or nothing if the transactions
+          *         are cheap enough to be precomputed on the calling thread
+          */
+         static vector<size_t> precompute_chunks( const signed_block& block, const uint32_t skip,
+                                                  const uint32_t threads );
    private:
          template<typename Trx>
          void _precompute_parallel( const Trx* trx, const size_t count, const uint32_t skip )const;
@@ -491,7 +553,8 @@ namespace graphene { namespace chain {
 
       private:
          void                  _apply_block( const signed_block& next_block );
-         processed_transaction _apply_transaction( const signed_transaction& trx );
+         processed_transaction _apply_transaction( const signed_transaction& trx,
+                                                   flat_set<account_id_type>* authority_accounts = nullptr );
          void                  _cancel_bids_and_revive_mpa( const asset_object& bitasset, const asset_bitasset_data_object& bad );
 
          ///Steps involved in applying a new block
@@ -504,6 +567,14 @@ namespace graphene { namespace chain {
          //////////////////// db_witness_schedule.cpp ////////////////////
 
          uint32_t update_witness_missed_blocks( const signed_block& b );
+         /// Rebuild the precomputed schedule from the state of the head block
+         void update_witness_schedule_table();
+         /// @return the schedule computed from the state of the head block, or nullptr if there are no witnesses
+         std::shared_ptr<const witness_schedule_table> build_witness_schedule_table()const;
+         /// @return the precomputed schedule if it matches the head block, otherwise nullptr
+         const witness_schedule_table* current_witness_schedule_table()const;
+         witness_id_type compute_scheduled_witness( uint32_t slot_num )const;
+         fc::time_point_sec compute_slot_time( uint32_t slot_num )const;
 
          //////////////////// db_update.cpp ////////////////////
          void update_global_dynamic_data( const signed_block& b, const uint32_t missed_blocks );
@@ -540,9 +611,35 @@ namespace graphene { namespace chain {
          ///@}
          ///@}
 
-         vector< processed_transaction >        _pending_tx;
+         processed_transaction _push_transaction_to_pending( const precomputable_transaction& trx,
+                                                             const pending_transaction* verified );
+         void discard_pending_tx_session();
+         void record_authority_changes( const undo_state& changes );
+         bool pending_authorities_unchanged( const pending_transaction& ptx )const;
+
+         pending_transaction_index              _pending_tx;
+         /// Sum of the packed sizes of the pending transactions
+         size_t                                 _pending_tx_packed_size = 0;
+         /// Union of the skip flags the pending transactions were applied with
+         uint32_t                               _pending_tx_skip_flags = skip_nothing;
+         /// Whether the pending state is exactly the result of applying _pending_tx in order on top of the head block
+         bool                                   _pending_state_matches_queue = true;
          fork_database                          _fork_db;
 
+         /// Accounts whose authorities, or whose existence, changed since the pending transactions were validated
+         flat_set<account_id_type>              _pending_authority_changes;
+         /// Set when the authority changes could not be tracked, e.g. because undo was disabled
+         bool                                   _pending_authorities_all_changed = false;
+
+         const account_authority_version_index* _account_authority_versions = nullptr;
+         const fee_table_cache*                 _fee_table_cache = nullptr;
+         proposal_authorization_index*          _proposal_authorizations = nullptr;
+         const asset_authorization_index*       _asset_authorizations = nullptr;
+         /// Rebuilt by update_witness_schedule_table(), only used while it matches the head block
+         std::shared_ptr<const witness_schedule_table> _witness_schedule_table;
+         authority_cache                        _authority_cache;
+         operation_profiler                     _operation_profiler;
+
          /**
           *  Note: we can probably store blocks by block num rather than
           *  block id because after the undo window is past the block ID
@@ -68,7 +68,7 @@ struct skip_flags_restorer
  */
 struct pending_transactions_restorer
 {
-   pending_transactions_restorer( database& db, std::vector<processed_transaction>&& pending_transactions )
+   pending_transactions_restorer( database& db, pending_transaction_index&& pending_transactions )
       : _db(db), _pending_transactions( std::move(pending_transactions) )
    {
       _db.clear_pending();
@@ -86,22 +86,31 @@ struct pending_transactions_restorer
          }
       }
       _db._popped_tx.clear();
-      for( const processed_transaction& tx : _pending_transactions )
+
+      // expired transactions can be dropped without applying them again
+      if( _db.head_block_num() > 0 )
+      {
+         auto& by_exp = _pending_transactions.get<by_expiration>();
+         by_exp.erase( by_exp.begin(), by_exp.lower_bound( _db.head_block_time() ) );
+      }
+
+      for( const pending_transaction& ptx : _pending_transactions )
       {
          try
          {
-            if( !_db.is_known_transaction( tx.id() ) ) {
-               _db._push_transaction( tx );
+            if( !_db.is_known_transaction( ptx.id ) ) {
+               _db._push_pending_transaction( ptx );
             }
          }
          catch( const fc::exception& )
          { // ignore invalid transactions
          }
       }
+      _db.reset_pending_authority_changes();
    }
 
    database& _db;
-   std::vector< processed_transaction > _pending_transactions;
+   pending_transaction_index _pending_transactions;
 };
 
 /**
@@ -131,7 +140,7 @@ void with_skip_flags(
 template< typename Lambda >
 void without_pending_transactions(
    database& db,
-   std::vector<processed_transaction>&& pending_transactions,
+   pending_transaction_index&& pending_transactions,
    Lambda callback )
 {
     pending_transactions_restorer restorer( db, std::move(pending_transactions) );
@@ -118,6 +118,7 @@ namespace graphene { namespace chain {
       const asset_object*              fee_asset          = nullptr;
       const asset_dynamic_data_object* fee_asset_dyn_data = nullptr;
       transaction_evaluation_state*    trx_state;
+      operation_profiler::sample*      profile_sample = nullptr;
    };
 
    class op_evaluator
@@ -149,16 +150,20 @@ namespace graphene { namespace chain {
          auto* eval = static_cast<DerivedEvaluator*>(this);
          const auto& op = o.get<typename DerivedEvaluator::operation_type>();
 
-         prepare_fee(op.fee_payer(), op.fee);
-         if( !trx_state->skip_fee_schedule_check )
          {
-            share_type required_fee = calculate_fee_for_operation(op);
-            GRAPHENE_ASSERT( core_fee_paid >= required_fee,
-                       insufficient_fee,
-                       "Insufficient Fee Paid",
-                       ("core_fee_paid",core_fee_paid)("required", required_fee) );
+            operation_profiler::scoped_stage timer( profile_sample, operation_profiler::fee_stage );
+            prepare_fee(op.fee_payer(), op.fee);
+            if( !trx_state->skip_fee_schedule_check )
+            {
+               share_type required_fee = calculate_fee_for_operation(op);
+               GRAPHENE_ASSERT( core_fee_paid >= required_fee,
+                          insufficient_fee,
+                          "Insufficient Fee Paid",
+                          ("core_fee_paid",core_fee_paid)("required", required_fee) );
+            }
          }
 
+         operation_profiler::scoped_stage timer( profile_sample, operation_profiler::evaluate_stage );
          return eval->do_evaluate(op);
       }
 
@@ -167,11 +172,19 @@ namespace graphene { namespace chain {
          auto* eval = static_cast<DerivedEvaluator*>(this);
          const auto& op = o.get<typename DerivedEvaluator::operation_type>();
 
-         convert_fee();
-         pay_fee();
+         {
+            operation_profiler::scoped_stage timer( profile_sample, operation_profiler::fee_stage );
+            convert_fee();
+            pay_fee();
+         }
 
-         auto result = eval->do_apply(op);
+         operation_result result;
+         {
+            operation_profiler::scoped_stage timer( profile_sample, operation_profiler::apply_stage );
+            result = eval->do_apply(op);
+         }
 
+         operation_profiler::scoped_stage timer( profile_sample, operation_profiler::fee_stage );
          db_adjust_balance(op.fee_payer(), -fee_from_account);
 
          return result;
@@ -47,7 +47,14 @@ namespace graphene { namespace chain {
       weak_ptr< fork_item > prev;
       uint32_t              num;    // initialized in ctor
       block_id_type         id;
+      /// the transactions keep their cached ids and signature keys across fork switches
       signed_block          data;
+      /**
+       * The skip flags the block was applied with, set once it has been applied successfully. Applying it again on
+       * top of the same ancestors, e.g. when switching back to its fork, has the same outcome, so the checks which do
+       * not modify the state and which were done then need not be repeated.
+       */
+      optional<uint32_t>    applied_skip_flags;
    };
    typedef shared_ptr<fork_item> item_ptr;
 
@@ -25,10 +25,15 @@
 
 #include <graphene/protocol/chain_parameters.hpp>
 #include <graphene/chain/types.hpp>
+#include <graphene/db/index.hpp>
 #include <graphene/db/object.hpp>
 
 #include <fc/uint128.hpp>
 
+#include <memory>
+
+namespace graphene { namespace protocol { class fee_table; } }
+
 namespace graphene { namespace chain {
 
    /**
@@ -122,6 +127,30 @@ namespace graphene { namespace chain {
             maintenance_flag = 0x01
          };
    };
+
+   /**
+    *  @brief This secondary index keeps the current fee schedule flattened into a @ref fee_table
+    *
+    *  The table is rebuilt whenever the global properties change, including when such a change is undone, so
+    *  it always matches the chain parameters.
+    */
+   class fee_table_cache : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// @return the current table, only to be called by the thread which modifies the database
+         const fee_table& get_table()const;
+         /// @return the current table, which remains valid while the caller holds it
+         std::shared_ptr<const fee_table> get_shared_table()const;
+
+      private:
+         void rebuild( const object& obj );
+
+         std::shared_ptr<const fee_table> table;
+   };
 }}
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::dynamic_global_property_object)
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/db/object_database.hpp>
+
+namespace graphene { namespace chain {
+
+   enum class object_change
+   {
+      created,
+      modified,
+      removed
+   };
+
+   /**
+    *  @brief The objects created, modified and removed by a block, grouped by object type
+    *
+    *  The ids of each kind of change are ordered by space, type and instance, so the changes of a single object
+    *  type form a contiguous range. The accounts impacted by a kind of change are only determined when asked
+    *  for, once. A change set refers to the undo state it was built from and must not outlive it.
+    */
+   class object_change_set
+   {
+   public:
+      typedef std::pair< vector<object_id_type>::const_iterator, vector<object_id_type>::const_iterator > id_range;
+
+      object_change_set( const object_database& db, const graphene::db::undo_state& state );
+
+      /// @return the ids of all objects with the given change
+      const vector<object_id_type>& ids( object_change change )const { return get( change ).ids; }
+      /// @return the ids of the objects of the given type with the given change
+      id_range ids( object_change change, uint8_t space, uint8_t type )const;
+
+      /// @return the last values of the removed objects, in the order of ids( object_change::removed )
+      const vector<const object*>& removed_objects()const { return _removed.objects; }
+
+      /// @return the accounts impacted by the changes of the given kind, see get_relevant_accounts
+      const flat_set<account_id_type>& impacted_accounts( object_change change )const;
+
+      bool empty()const { return _created.ids.empty() && _modified.ids.empty() && _removed.ids.empty(); }
+
+   private:
+      struct changes
+      {
+         vector<object_id_type>                          ids;
+         /// the values the impacted accounts are derived from, null for objects to be looked up
+         vector<const object*>                           objects;
+         mutable optional< flat_set<account_id_type> >   accounts;
+      };
+
+      const changes& get( object_change change )const;
+
+      const object_database& _db;
+      changes                _created;
+      changes                _modified;
+      changes                _removed;
+   };
+
+} } // graphene::chain
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/protocol/operations.hpp>
+#include <graphene/db/object_database.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace graphene { namespace chain {
+
+   /// Statistics of one evaluation stage of one operation type, times are in nanoseconds
+   struct operation_stage_profile
+   {
+      string   stage;
+      uint64_t count = 0;
+      uint64_t total_time = 0;
+      /// The percentiles are upper bounds which are at most twice the exact value
+      uint64_t p50_time = 0;
+      uint64_t p90_time = 0;
+      uint64_t p99_time = 0;
+      uint64_t max_time = 0;
+   };
+
+   /// Statistics of one operation type
+   struct operation_profile
+   {
+      string                           operation;
+      uint64_t                         count = 0;
+      uint64_t                         failures = 0;
+      uint64_t                         objects_created = 0;
+      uint64_t                         objects_modified = 0;
+      uint64_t                         objects_removed = 0;
+      vector<operation_stage_profile>  stages;
+   };
+
+   /**
+    * @brief Collects call counts, times and object changes of operations by type and evaluation stage
+    *
+    * The profiler is disabled by default, which costs database::apply_operation one check of a flag. When enabled,
+    * the stages of each evaluation are timed with a steady clock and added to histograms with power-of-two
+    * buckets, so recording takes constant time and still allows percentiles to be reported.
+    *
+    * An operation executed by a proposal is profiled on its own, and is also part of the apply stage of the
+    * operation executing the proposal. The object changes of an operation are counted in the same way.
+    *
+    * Operations are recorded by the thread applying blocks, the profile can be read from any thread.
+    */
+   class operation_profiler
+   {
+   public:
+      typedef std::chrono::steady_clock clock;
+
+      enum stage
+      {
+         validate_stage, ///< the stateless checks of the operation
+         fee_stage,      ///< preparation, check, conversion and payment of the fee
+         evaluate_stage, ///< do_evaluate of the evaluator
+         apply_stage,    ///< do_apply of the evaluator
+         total_stage,    ///< all of database::apply_operation, except the validation
+         stage_count
+      };
+
+      /// The times of the stages of one evaluation
+      struct sample
+      {
+         std::array<uint64_t, stage_count> times{};
+      };
+
+      /// Adds the time between its construction and destruction to a stage of a sample, if there is a sample
+      class scoped_stage
+      {
+      public:
+         scoped_stage( sample* s, stage st ) : _sample( s ), _stage( st )
+         {
+            if( _sample != nullptr )
+               _start = clock::now();
+         }
+         ~scoped_stage()
+         {
+            if( _sample != nullptr )
+               _sample->times[_stage] += elapsed( _start );
+         }
+      private:
+         sample*           _sample;
+         stage             _stage;
+         clock::time_point _start;
+      };
+
+      static uint64_t elapsed( clock::time_point start )
+      {
+         return std::chrono::duration_cast<std::chrono::nanoseconds>( clock::now() - start ).count();
+      }
+
+      bool is_enabled()const { return _enabled.load( std::memory_order_relaxed ); }
+      /// Starts or stops recording, the statistics collected so far are kept
+      void enable( bool enabled ) { _enabled.store( enabled, std::memory_order_relaxed ); }
+      void reset();
+
+      /**
+       * Validates the operations of a transaction like trx.validate(), and records their times.
+       * Precomputable transactions which have been validated before are not validated again, nor timed.
+       */
+      void validate( const transaction& trx );
+
+      void record( int which, const sample& s, const graphene::db::object_change_counts& changes );
+      void record_failure( int which );
+
+      /// @return the statistics of the operation types which have been recorded, by operation type
+      vector<operation_profile> get_profile()const;
+      /// Logs the statistics of the operation types which have been recorded, by descending total time
+      void log_profile()const;
+
+   private:
+      struct stage_statistics
+      {
+         uint64_t                   count = 0;
+         uint64_t                   total_time = 0;
+         uint64_t                   max_time = 0;
+         /// Bucket i counts the times t with 2^i <= t < 2^(i+1), and bucket 0 the times below 2
+         std::array<uint64_t, 64>   histogram{};
+
+         void add( uint64_t time );
+         uint64_t percentile( double fraction )const;
+      };
+
+      struct operation_statistics
+      {
+         uint64_t                                       count = 0;
+         uint64_t                                       failures = 0;
+         graphene::db::object_change_counts             changes;
+         std::array<stage_statistics, stage_count>      stages;
+      };
+
+      operation_statistics& statistics( int which );
+
+      std::atomic<bool>                _enabled{ false };
+      mutable std::mutex               _mutex;
+      vector<operation_statistics>     _statistics;
+   };
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::operation_stage_profile,
+            (stage)(count)(total_time)(p50_time)(p90_time)(p99_time)(max_time) )
+FC_REFLECT( graphene::chain::operation_profile,
+            (operation)(count)(failures)(objects_created)(objects_modified)(objects_removed)(stages) )
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/protocol/transaction.hpp>
+
+#include <graphene/chain/types.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+namespace graphene { namespace chain {
+   using boost::multi_index_container;
+   using namespace boost::multi_index;
+
+   /**
+    *  A transaction in the pending queue, together with the information needed to decide cheaply
+    *  whether it has to be fully revalidated after the head block changed.
+    */
+   struct pending_transaction
+   {
+      pending_transaction( processed_transaction t, uint32_t skip, flat_set<account_id_type> auth_accounts,
+                           uint32_t max_depth, bool allow_owner )
+      : trx( std::move(t) ),
+        id( trx.id() ),
+        expiration( trx.expiration ),
+        fee_payer( trx.operations.front().visit( fee_payer_visitor() ) ),
+        // the size of the unsigned part is cached, see processed_transaction for the remaining fields
+        packed_size( trx.get_packed_size() + fc::raw::pack_size( trx.signatures )
+                     + fc::raw::pack_size( trx.operation_results ) ),
+        skip_flags( skip ),
+        authority_accounts( std::move(auth_accounts) ),
+        max_authority_depth( max_depth ),
+        allow_non_immediate_owner( allow_owner )
+      {}
+
+      processed_transaction      trx;
+      transaction_id_type        id;
+      time_point_sec             expiration;
+      /// fee payer of the first operation
+      account_id_type            fee_payer;
+      /// packed size of the processed transaction, as it would be included in a block
+      size_t                     packed_size;
+      /// the database::validation_steps that were skipped when the transaction was applied
+      uint32_t                   skip_flags;
+      /// accounts whose active or owner authorities were looked up by the last authority check
+      flat_set<account_id_type>  authority_accounts;
+      /// the authority check parameters used by the last authority check
+      ///@{
+      uint32_t                   max_authority_depth;
+      bool                       allow_non_immediate_owner;
+      ///@}
+
+      /// whether the signatures of the transaction have been checked against the authorities
+      bool authority_verified()const;
+
+   private:
+      struct fee_payer_visitor
+      {
+         typedef account_id_type result_type;
+         template<typename Op>
+         account_id_type operator()( const Op& op )const { return op.fee_payer(); }
+      };
+   };
+
+   struct by_arrival;
+   struct by_trx_id;
+   struct by_expiration;
+   struct by_fee_payer;
+
+   /**
+    *  The pending transaction queue. Iteration in the default (first) index follows arrival order, which is the
+    *  order the transactions have been applied to the pending state.
+    */
+   typedef multi_index_container<
+      pending_transaction,
+      indexed_by<
+         sequenced< tag<by_arrival> >,
+         hashed_unique< tag<by_trx_id>, member< pending_transaction, transaction_id_type, &pending_transaction::id >,
+                        std::hash<transaction_id_type> >,
+         ordered_non_unique< tag<by_expiration>,
+                             member< pending_transaction, time_point_sec, &pending_transaction::expiration > >,
+         ordered_non_unique< tag<by_fee_payer>,
+                             member< pending_transaction, account_id_type, &pending_transaction::fee_payer > >
+      >
+   > pending_transaction_index;
+
+} } // graphene::chain
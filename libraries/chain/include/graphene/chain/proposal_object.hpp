@@ -26,6 +26,7 @@
 #include <graphene/protocol/types.hpp>
 #include <graphene/protocol/transaction.hpp>
 #include <graphene/db/generic_index.hpp>
+#include <graphene/db/reference_tracker.hpp>
 
 #include <boost/multi_index/composite_key.hpp>
 
@@ -57,6 +58,13 @@ class proposal_object : public abstract_object<proposal_object>
       bool is_authorized_to_execute(database& db) const;
 };
 
+/** The accounts whose approval a proposal requires or has received */
+struct proposal_approval_accounts
+{
+   typedef account_id_type key_type;
+   void operator()( const proposal_object& p, vector<account_id_type>& accounts )const;
+};
+
 /**
  *  @brief tracks all of the proposal objects that requrie approval of
  *  an individual account.   
@@ -65,8 +73,6 @@ class proposal_object : public abstract_object<proposal_object>
  *  @ingroup protocol
  *
  *  This is a secondary index on the proposal_index
- *
- *  @note the set of required approvals is constant
  */
 class required_approval_index : public secondary_index
 {
@@ -76,14 +82,54 @@ class required_approval_index : public secondary_index
       virtual void about_to_modify( const object& before ) override;
       virtual void object_modified( const object& after  ) override;
 
-      map<account_id_type, set<proposal_id_type> > _account_to_proposals;
+      reference_map<account_id_type, proposal_id_type> _account_to_proposals;
+
+   private:
+      reference_tracker< proposal_object, proposal_id_type, proposal_approval_accounts >
+            approvals { _account_to_proposals };
+};
+
+/**
+ *  @brief Remembers the outcome of the last authorization check of every proposal
+ *
+ *  Checking whether a proposal may be executed walks the authorities of every account involved in the proposed
+ *  transaction. The outcome stays the same until one of the authorities looked up changes, the key approvals
+ *  change, an account which appears in one of the authorities walked is approved or unapproved, or the check
+ *  parameters change. This index keeps the outcome together with what it depends on, and forgets it as soon as the
+ *  proposal is modified in a way which could affect it. Approvals by accounts which play no role in the remaining
+ *  requirements, and the check at expiration, then don't walk the authorities again.
+ *
+ *  This is a secondary index on the proposal_index. It is not part of the consensus state, an outcome which is not
+ *  remembered is simply computed again.
+ */
+class proposal_authorization_index : public secondary_index
+{
+   public:
+      virtual void object_removed( const object& obj ) override;
+      virtual void about_to_modify( const object& before ) override;
+      virtual void object_modified( const object& after  ) override;
+
+      /// @see proposal_object::is_authorized_to_execute()
+      bool is_authorized_to_execute( const proposal_object& proposal, database& db );
 
    private:
-      void remove( account_id_type a, proposal_id_type p );
-      void insert_or_remove_delta( proposal_id_type p, const flat_set<account_id_type>& before,
-                                   const flat_set<account_id_type>& after );
-      flat_set<account_id_type> available_active_before_modify;
-      flat_set<account_id_type> available_owner_before_modify;
+      struct outcome
+      {
+         bool                                  authorized = false;
+         bool                                  allow_non_immediate_owner = false;
+         uint32_t                              max_authority_depth = 0;
+         /// the accounts whose authorities were looked up, with their versions
+         flat_map<account_id_type, uint64_t>   authority_versions;
+         /// the accounts whose approval or unapproval may change the outcome
+         flat_set<account_id_type>             referenced_accounts;
+      };
+
+      outcome check_authorization( const proposal_object& proposal, database& db )const;
+
+      map<proposal_id_type, outcome> _outcomes;
+      flat_set<account_id_type>      available_active_before_modify;
+      flat_set<account_id_type>      available_owner_before_modify;
+      flat_set<public_key_type>      available_key_before_modify;
 };
 
 struct by_expiration{};
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #pragma once
+#include <graphene/chain/operation_profiler.hpp>
 #include <graphene/protocol/operations.hpp>
 
 namespace graphene {
@@ -49,5 +50,7 @@ namespace chain {
          bool                             _is_proposed_trx = false;
          bool                             skip_fee = false;
          bool                             skip_fee_schedule_check = false;
+         /// Receives the stage times of the operation being evaluated while the operation profiler is enabled
+         operation_profiler::sample*      profile_sample = nullptr;
    };
 } } // namespace graphene::chain
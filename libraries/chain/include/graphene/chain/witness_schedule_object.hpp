@@ -36,6 +36,43 @@ class witness_schedule_object : public graphene::db::abstract_object<witness_sch
       vector< witness_id_type > current_shuffled_witnesses;
 };
 
+/**
+ *  @brief The witness schedule following a head block, precomputed for fast slot lookups
+ *
+ *  The table is built by the database after each block from the global properties, the witness schedule and the
+ *  witness objects. It is never modified once built, so it may be shared with other threads, which can answer
+ *  slot queries without touching the object database. The answers are those of the head block the table was
+ *  built for.
+ */
+class witness_schedule_table
+{
+   public:
+      struct slot
+      {
+         fc::time_point_sec time;
+         witness_id_type    witness;
+         public_key_type    signing_key;
+      };
+
+      /// The head block the table was built for
+      block_id_type  head_block_id;
+      uint8_t        block_interval = 0;
+      /// Slots 1 to N after the head block, where N is the number of scheduled witnesses
+      vector<slot>   slots;
+
+      /// @see database::get_scheduled_witness()
+      witness_id_type    get_scheduled_witness( uint32_t slot_num )const;
+      /// @see database::get_slot_time()
+      fc::time_point_sec get_slot_time( uint32_t slot_num )const;
+      /// @see database::get_slot_at_time()
+      uint32_t           get_slot_at_time( fc::time_point_sec when )const;
+      /// @return the signing key of the witness scheduled in a slot, as of the head block
+      const public_key_type& get_scheduled_signing_key( uint32_t slot_num )const;
+
+   private:
+      const slot& get_slot( uint32_t slot_num )const;
+};
+
 } }
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::witness_schedule_object)
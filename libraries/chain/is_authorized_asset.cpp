@@ -44,6 +44,13 @@ bool _is_authorized_asset(
       // must still pass other checks even if it is in allowed_assets
    }
 
+   return d.get_asset_authorizations().is_listed_authorized( acct, asset_obj );
+}
+
+} // detail
+
+bool asset_authorization_index::check( const account_object& acct, const asset_object& asset_obj )
+{
    for( const auto id : acct.blacklisting_accounts )
    {
       if( asset_obj.options.blacklist_authorities.find(id) != asset_obj.options.blacklist_authorities.end() )
@@ -62,6 +69,74 @@ bool _is_authorized_asset(
    return false;
 }
 
-} // detail
+bool asset_authorization_index::is_listed_authorized( const account_object& acct, const asset_object& asset_obj )const
+{
+   // nothing to look up, not worth a cache entry
+   if( asset_obj.options.blacklist_authorities.empty() && asset_obj.options.whitelist_authorities.empty() )
+      return true;
+
+   const auto asset_instance = asset_obj.id.instance();
+   if( verdicts.size() <= asset_instance )
+      verdicts.resize( asset_instance + 1 );
+   auto& by_account = verdicts[asset_instance];
+   auto itr = by_account.find( acct.id.instance() );
+   if( itr == by_account.end() )
+      itr = by_account.emplace( acct.id.instance(), check( acct, asset_obj ) ).first;
+   return itr->second;
+}
+
+void asset_authorization_index::account_lists_changed( account_id_type account )
+{
+   for( auto& by_account : verdicts )
+      by_account.erase( account.instance.value );
+}
+
+size_t asset_authorization_index::size()const
+{
+   size_t result = 0;
+   for( const auto& by_account : verdicts )
+      result += by_account.size();
+   return result;
+}
+
+void asset_authorization_index::object_removed( const object& obj )
+{
+   const auto instance = obj.id.instance();
+   if( instance < verdicts.size() )
+      verdicts[instance].clear();
+}
+
+void asset_authorization_index::about_to_modify( const object& before )
+{
+   const asset_object& a = static_cast<const asset_object&>(before);
+   before_whitelist = a.options.whitelist_authorities;
+   before_blacklist = a.options.blacklist_authorities;
+}
+
+void asset_authorization_index::object_modified( const object& after  )
+{
+   const asset_object& a = static_cast<const asset_object&>(after);
+   if( a.options.whitelist_authorities != before_whitelist || a.options.blacklist_authorities != before_blacklist )
+      object_removed( after );
+}
+
+void account_listing_observer::object_removed( const object& obj )
+{
+   _authorizations->account_lists_changed( obj.id );
+}
+
+void account_listing_observer::about_to_modify( const object& before )
+{
+   const account_object& a = static_cast<const account_object&>(before);
+   before_whitelisting = a.whitelisting_accounts;
+   before_blacklisting = a.blacklisting_accounts;
+}
+
+void account_listing_observer::object_modified( const object& after  )
+{
+   const account_object& a = static_cast<const account_object&>(after);
+   if( a.whitelisting_accounts != before_whitelisting || a.blacklisting_accounts != before_blacklisting )
+      _authorizations->account_lists_changed( after.id );
+}
 
 } } // graphene::chain
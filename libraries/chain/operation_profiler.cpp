@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/operation_profiler.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+const char* const stage_names[] = { "validate", "fee", "evaluate", "apply", "total" };
+
+struct operation_name_visitor
+{
+   typedef string result_type;
+
+   template<typename Op>
+   string operator()( const Op& )const
+   {
+      const string name = fc::get_typename<Op>::name();
+      const auto pos = name.rfind( "::" );
+      return pos == string::npos ? name : name.substr( pos + 2 );
+   }
+};
+
+string operation_name( int which )
+{
+   operation op;
+   op.set_which( which );
+   return op.visit( operation_name_visitor() );
+}
+
+} // anonymous namespace
+
+void operation_profiler::stage_statistics::add( uint64_t time )
+{
+   ++count;
+   total_time += time;
+   max_time = std::max( max_time, time );
+   uint32_t bucket = 0;
+   for( uint64_t t = time >> 1; t != 0; t >>= 1 )
+      ++bucket;
+   ++histogram[bucket];
+}
+
+uint64_t operation_profiler::stage_statistics::percentile( double fraction )const
+{
+   if( count == 0 )
+      return 0;
+   const uint64_t rank = std::max<uint64_t>( 1, uint64_t( std::ceil( fraction * count ) ) );
+   uint64_t seen = 0;
+   for( size_t i = 0; i < histogram.size(); ++i )
+   {
+      seen += histogram[i];
+      if( seen >= rank )
+         return std::min( max_time, ( uint64_t(2) << i ) - 1 );
+   }
+   return max_time;
+}
+
+operation_profiler::operation_statistics& operation_profiler::statistics( int which )
+{
+   if( _statistics.empty() )
+      _statistics.resize( operation::count() );
+   return _statistics[which];
+}
+
+void operation_profiler::reset()
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   _statistics.clear();
+}
+
+void operation_profiler::validate( const transaction& trx )
+{
+   const auto timed_validate = [this]( const operation& op ) {
+      const clock::time_point start = clock::now();
+      operation_validate( op );
+      const uint64_t time = elapsed( start );
+
+      std::lock_guard<std::mutex> guard( _mutex );
+      statistics( op.which() ).stages[validate_stage].add( time );
+   };
+
+   // keep the result cached by the transaction, like precomputable_transaction::validate
+   if( const auto* precomputable = dynamic_cast<const precomputable_transaction*>( &trx ) )
+   {
+      precomputable->validate( timed_validate );
+      return;
+   }
+   trx.validate_operations( timed_validate );
+}
+
+void operation_profiler::record( int which, const sample& s, const graphene::db::object_change_counts& changes )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   operation_statistics& stats = statistics( which );
+   ++stats.count;
+   stats.changes.created += changes.created;
+   stats.changes.modified += changes.modified;
+   stats.changes.removed += changes.removed;
+   for( int i = fee_stage; i < stage_count; ++i )
+      stats.stages[i].add( s.times[i] );
+}
+
+void operation_profiler::record_failure( int which )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   ++statistics( which ).failures;
+}
+
+vector<operation_profile> operation_profiler::get_profile()const
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   vector<operation_profile> result;
+   for( size_t which = 0; which < _statistics.size(); ++which )
+   {
+      const operation_statistics& stats = _statistics[which];
+      if( stats.count == 0 && stats.failures == 0 && stats.stages[validate_stage].count == 0 )
+         continue;
+
+      operation_profile profile;
+      profile.operation = operation_name( which );
+      profile.count = stats.count;
+      profile.failures = stats.failures;
+      profile.objects_created = stats.changes.created;
+      profile.objects_modified = stats.changes.modified;
+      profile.objects_removed = stats.changes.removed;
+      for( int i = 0; i < stage_count; ++i )
+      {
+         const stage_statistics& st = stats.stages[i];
+         operation_stage_profile stage_profile;
+         stage_profile.stage = stage_names[i];
+         stage_profile.count = st.count;
+         stage_profile.total_time = st.total_time;
+         stage_profile.p50_time = st.percentile( 0.5 );
+         stage_profile.p90_time = st.percentile( 0.9 );
+         stage_profile.p99_time = st.percentile( 0.99 );
+         stage_profile.max_time = st.max_time;
+         profile.stages.push_back( std::move( stage_profile ) );
+      }
+      result.push_back( std::move( profile ) );
+   }
+   return result;
+}
+
+void operation_profiler::log_profile()const
+{
+   vector<operation_profile> profile = get_profile();
+   std::sort( profile.begin(), profile.end(), []( const operation_profile& a, const operation_profile& b ) {
+      return a.stages[total_stage].total_time > b.stages[total_stage].total_time;
+   });
+
+   ilog( "Operation profile of ${n} operation types, times in nanoseconds:", ("n", profile.size()) );
+   for( const operation_profile& op : profile )
+   {
+      ilog( "${op}: ${n} applied, ${f} failed, ${c} objects created, ${m} modified, ${r} removed",
+            ("op", op.operation)("n", op.count)("f", op.failures)
+            ("c", op.objects_created)("m", op.objects_modified)("r", op.objects_removed) );
+      for( const operation_stage_profile& st : op.stages )
+         ilog( "   ${s}: ${n} times, total ${t}, p50 ${p50}, p90 ${p90}, p99 ${p99}, max ${max}",
+               ("s", st.stage)("n", st.count)("t", st.total_time)
+               ("p50", st.p50_time)("p90", st.p90_time)("p99", st.p99_time)("max", st.max_time) );
+   }
+}
+
+} } // graphene::chain
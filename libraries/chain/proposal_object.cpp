@@ -21,6 +21,7 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <graphene/chain/account_object.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/hardfork.hpp>
 #include <graphene/chain/transaction_evaluation_state.hpp>
@@ -30,106 +31,144 @@ namespace graphene { namespace chain {
 
 bool proposal_object::is_authorized_to_execute(database& db) const
 {
-   transaction_evaluation_state dry_run_eval(&db);
+   return db.get_proposal_authorizations().is_authorized_to_execute( *this, db );
+}
+
+proposal_authorization_index::outcome proposal_authorization_index::check_authorization(
+      const proposal_object& proposal, database& db )const
+{
+   outcome result;
+   result.allow_non_immediate_owner = ( db.head_block_time() >= HARDFORK_CORE_584_TIME );
+   result.max_authority_depth = db.get_global_properties().parameters.max_authority_depth;
+
+   // the top level requirements are checked against the approvals directly
+   flat_set<account_id_type> required_active;
+   flat_set<account_id_type> required_owner;
+   vector<authority> other;
+   for( const auto& op : proposal.proposed_transaction.operations )
+      operation_get_required_authorities( op, required_active, required_owner, other );
+   result.referenced_accounts.insert( required_active.begin(), required_active.end() );
+   result.referenced_accounts.insert( required_owner.begin(), required_owner.end() );
+   for( const authority& auth : other )
+      for( const auto& a : auth.account_auths )
+         result.referenced_accounts.insert( a.first );
+
+   // every authority looked up may be satisfied by approvals of the accounts it contains
+   auto look_up = [&db,&result]( account_id_type id, bool owner ) -> const authority* {
+      result.authority_versions[id] = db.get_account_authority_version( id );
+      const account_object& account = id(db);
+      const authority& auth = owner ? account.owner : account.active;
+      for( const auto& a : auth.account_auths )
+         result.referenced_accounts.insert( a.first );
+      return &auth;
+   };
 
    try {
-      bool allow_non_immediate_owner = ( db.head_block_time() >= HARDFORK_CORE_584_TIME );
-      verify_authority( proposed_transaction.operations, 
-                        available_key_approvals,
-                        [&]( account_id_type id ){ return &id(db).active; },
-                        [&]( account_id_type id ){ return &id(db).owner;  },
-                        allow_non_immediate_owner,
-                        db.get_global_properties().parameters.max_authority_depth,
+      verify_authority( proposal.proposed_transaction.operations,
+                        proposal.available_key_approvals,
+                        [&]( account_id_type id ){ return look_up( id, false ); },
+                        [&]( account_id_type id ){ return look_up( id, true );  },
+                        result.allow_non_immediate_owner,
+                        result.max_authority_depth,
                         true, /* allow committee */
-                        available_active_approvals,
-                        available_owner_approvals );
-   } 
+                        proposal.available_active_approvals,
+                        proposal.available_owner_approvals );
+      result.authorized = true;
+   }
    catch ( const fc::exception& e )
    {
-      return false;
+      result.authorized = false;
    }
-   return true;
+   return result;
 }
 
-void required_approval_index::object_inserted( const object& obj )
+bool proposal_authorization_index::is_authorized_to_execute( const proposal_object& proposal, database& db )
 {
-    assert( dynamic_cast<const proposal_object*>(&obj) );
-    const proposal_object& p = static_cast<const proposal_object&>(obj);
-
-    for( const auto& a : p.required_active_approvals )
-       _account_to_proposals[a].insert( p.id );
-    for( const auto& a : p.required_owner_approvals )
-       _account_to_proposals[a].insert( p.id );
-    for( const auto& a : p.available_active_approvals )
-       _account_to_proposals[a].insert( p.id );
-    for( const auto& a : p.available_owner_approvals )
-       _account_to_proposals[a].insert( p.id );
+   auto itr = _outcomes.find( proposal.id );
+   if( itr != _outcomes.end() )
+   {
+      const outcome& o = itr->second;
+      bool valid = o.allow_non_immediate_owner == ( db.head_block_time() >= HARDFORK_CORE_584_TIME )
+                   && o.max_authority_depth == db.get_global_properties().parameters.max_authority_depth;
+      for( auto v = o.authority_versions.begin(); valid && v != o.authority_versions.end(); ++v )
+         valid = ( db.get_account_authority_version( v->first ) == v->second );
+      if( valid )
+         return o.authorized;
+   }
+   outcome o = check_authorization( proposal, db );
+   const bool authorized = o.authorized;
+   _outcomes[proposal.id] = std::move( o );
+   return authorized;
 }
 
-void required_approval_index::remove( account_id_type a, proposal_id_type p )
+void proposal_authorization_index::object_removed( const object& obj )
 {
-    auto itr = _account_to_proposals.find(a);
-    if( itr != _account_to_proposals.end() )
-    {
-        itr->second.erase( p );
-        if( itr->second.empty() )
-            _account_to_proposals.erase( itr->first );
-    }
+   _outcomes.erase( obj.id );
 }
 
-void required_approval_index::object_removed( const object& obj )
+void proposal_authorization_index::about_to_modify( const object& before )
+{
+   const proposal_object& p = static_cast<const proposal_object&>(before);
+   if( _outcomes.find( p.id ) == _outcomes.end() )
+      return;
+   available_active_before_modify = p.available_active_approvals;
+   available_owner_before_modify  = p.available_owner_approvals;
+   available_key_before_modify    = p.available_key_approvals;
+}
+
+void proposal_authorization_index::object_modified( const object& after )
+{
+   const proposal_object& p = static_cast<const proposal_object&>(after);
+   auto itr = _outcomes.find( p.id );
+   if( itr == _outcomes.end() )
+      return;
+
+   // the keys used decide whether there are unnecessary key approvals, any change may matter
+   bool keep = ( p.available_key_approvals == available_key_before_modify );
+   // approving or unapproving an account which is not referenced leaves the authority walk unchanged
+   auto unreferenced = [&itr]( const flat_set<account_id_type>& before, const flat_set<account_id_type>& after ) {
+      vector<account_id_type> changed;
+      std::set_symmetric_difference( before.begin(), before.end(), after.begin(), after.end(),
+                                     std::back_inserter( changed ) );
+      for( const auto& a : changed )
+         if( itr->second.referenced_accounts.find( a ) != itr->second.referenced_accounts.end() )
+            return false;
+      return true;
+   };
+   keep = keep && unreferenced( available_active_before_modify, p.available_active_approvals )
+               && unreferenced( available_owner_before_modify, p.available_owner_approvals );
+   if( !keep )
+      _outcomes.erase( itr );
+}
+
+void proposal_approval_accounts::operator()( const proposal_object& p, vector<account_id_type>& accounts )const
+{
+   accounts.insert( accounts.end(), p.required_active_approvals.begin(), p.required_active_approvals.end() );
+   accounts.insert( accounts.end(), p.required_owner_approvals.begin(), p.required_owner_approvals.end() );
+   accounts.insert( accounts.end(), p.available_active_approvals.begin(), p.available_active_approvals.end() );
+   accounts.insert( accounts.end(), p.available_owner_approvals.begin(), p.available_owner_approvals.end() );
+}
+
+void required_approval_index::object_inserted( const object& obj )
 {
     assert( dynamic_cast<const proposal_object*>(&obj) );
-    const proposal_object& p = static_cast<const proposal_object&>(obj);
-
-    for( const auto& a : p.required_active_approvals )
-       remove( a, p.id );
-    for( const auto& a : p.required_owner_approvals )
-       remove( a, p.id );
-    for( const auto& a : p.available_active_approvals )
-       remove( a, p.id );
-    for( const auto& a : p.available_owner_approvals )
-       remove( a, p.id );
+    approvals.inserted( static_cast<const proposal_object&>(obj) );
 }
 
-void required_approval_index::insert_or_remove_delta( proposal_id_type p,
-                                                      const flat_set<account_id_type>& before,
-                                                      const flat_set<account_id_type>& after )
+void required_approval_index::object_removed( const object& obj )
 {
-    auto b = before.begin();
-    auto a = after.begin();
-    while( b != before.end() || a != after.end() )
-    {
-       if( a == after.end() || (b != before.end() && *b < *a) )
-       {
-           remove( *b, p );
-           ++b;
-       }
-       else if( b == before.end() || (a != after.end() && *a < *b) )
-       {
-           _account_to_proposals[*a].insert( p );
-           ++a;
-       }
-       else // *a == *b
-       {
-           ++a;
-           ++b;
-       }
-    }
+    assert( dynamic_cast<const proposal_object*>(&obj) );
+    approvals.removed( static_cast<const proposal_object&>(obj) );
 }
 
 void required_approval_index::about_to_modify( const object& before )
 {
-    const proposal_object& p = static_cast<const proposal_object&>(before);
-    available_active_before_modify = p.available_active_approvals;
-    available_owner_before_modify  = p.available_owner_approvals;
+    approvals.about_to_modify( static_cast<const proposal_object&>(before) );
 }
 
 void required_approval_index::object_modified( const object& after )
 {
-    const proposal_object& p = static_cast<const proposal_object&>(after);
-    insert_or_remove_delta( p.id, available_active_before_modify, p.available_active_approvals );
-    insert_or_remove_delta( p.id, available_owner_before_modify,  p.available_owner_approvals );
+    approvals.modified( static_cast<const proposal_object&>(after) );
 }
 
 } } // graphene::chain
@@ -145,6 +145,39 @@ namespace graphene { namespace db {
          virtual void object_removed( const object& obj ){};
          virtual void about_to_modify( const object& before ){};
          virtual void object_modified( const object& after  ){};
+
+         /**
+          *  Whether the index can skip the notifications of a bulk load, see base_primary_index::begin_bulk_load.
+          *  Such an index must not be used during the bulk load.
+          */
+         virtual bool supports_bulk_load()const { return false; }
+         /** called at the end of a bulk load, replaces the content with the objects of the primary index */
+         virtual void rebuild( const index& primary ){ FC_THROW( "Bulk load is not supported by this index" ); }
+   };
+
+   /**
+    *  @brief A secondary index that maintains the digest of all objects of its primary index
+    *
+    *  The digest is the sum of the hashes of the objects, which is what index::hash() computes by a full scan.
+    *  Because a sum does not depend on the order of its terms it can be updated for each insertion, modification
+    *  and removal, including the ones made when undoing changes.
+    *
+    *  Note that maintaining the digest serializes every modified object twice.
+    */
+   class state_hash_index : public secondary_index
+   {
+      public:
+         explicit state_hash_index( const index* primary ) : _hash( primary->hash() ) {}
+
+         virtual void object_inserted( const object& obj )override { _hash += obj.hash(); }
+         virtual void object_removed( const object& obj )override  { _hash -= obj.hash(); }
+         virtual void about_to_modify( const object& before )override { _hash -= before.hash(); }
+         virtual void object_modified( const object& after )override  { _hash += after.hash(); }
+
+         const fc::uint128& hash()const { return _hash; }
+
+      private:
+         fc::uint128 _hash;
    };
 
    /**
@@ -171,9 +204,19 @@ namespace graphene { namespace db {
          T* add_secondary_index(Args... args)
          {
             _sindex.emplace_back( new T(args...) );
+            if( !_bulk_loading || !_sindex.back()->supports_bulk_load() )
+               _notified_sindex.push_back( _sindex.back().get() );
             return static_cast<T*>(_sindex.back().get());
          }
 
+         /**
+          *  Stop notifying the secondary indexes which support bulk loading about changes, so objects can be added
+          *  in large numbers without maintaining those indexes one object at a time.
+          */
+         void begin_bulk_load();
+         /** rebuild the secondary indexes which have not been notified since begin_bulk_load, and notify them again */
+         void end_bulk_load();
+
          template<typename T>
          const T& get_secondary_index()const
          {
@@ -188,9 +231,12 @@ namespace graphene { namespace db {
       protected:
          vector< shared_ptr<index_observer> >   _observers;
          vector< unique_ptr<secondary_index> >  _sindex;
+         /** the secondary indexes to notify, all of them unless bulk loading */
+         vector< secondary_index* >             _notified_sindex;
 
       private:
          object_database& _db;
+         bool             _bulk_loading = false;
    };
 
    /** @class direct_index
@@ -380,7 +426,7 @@ namespace graphene { namespace db {
          virtual const object&  load( const std::vector<char>& data )override
          {
             const auto& result = DerivedIndex::insert( fc::raw::unpack<object_type>( data ) );
-            for( const auto& item : _sindex )
+            for( secondary_index* item : _notified_sindex )
                item->object_inserted( result );
             return result;
          }
@@ -389,7 +435,7 @@ namespace graphene { namespace db {
          virtual const object&  create(const std::function<void(object&)>& constructor )override
          {
             const auto& result = DerivedIndex::create( constructor );
-            for( const auto& item : _sindex )
+            for( secondary_index* item : _notified_sindex )
                item->object_inserted( result );
             on_add( result );
             return result;
@@ -398,7 +444,7 @@ namespace graphene { namespace db {
          virtual const object& insert( object&& obj ) override
          {
             const auto& result = DerivedIndex::insert( std::move( obj ) );
-            for( const auto& item : _sindex )
+            for( secondary_index* item : _notified_sindex )
                item->object_inserted( result );
             on_add( result );
             return result;
@@ -406,7 +452,7 @@ namespace graphene { namespace db {
 
          virtual void  remove( const object& obj ) override
          {
-            for( const auto& item : _sindex )
+            for( secondary_index* item : _notified_sindex )
                item->object_removed( obj );
             on_remove(obj);
             DerivedIndex::remove(obj);
@@ -415,10 +461,10 @@ namespace graphene { namespace db {
          virtual void modify( const object& obj, const std::function<void(object&)>& m )override
          {
             save_undo( obj );
-            for( const auto& item : _sindex )
+            for( secondary_index* item : _notified_sindex )
                item->about_to_modify( obj );
             DerivedIndex::modify( obj, m );
-            for( const auto& item : _sindex )
+            for( secondary_index* item : _notified_sindex )
                item->object_modified( obj );
             on_modify( obj );
          }
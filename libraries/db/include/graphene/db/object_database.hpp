@@ -32,6 +32,14 @@
 
 namespace graphene { namespace db {
 
+   /// Numbers of objects created, modified and removed
+   struct object_change_counts
+   {
+      uint64_t created  = 0;
+      uint64_t modified = 0;
+      uint64_t removed  = 0;
+   };
+
    /**
     *   @class object_database
     *   @brief maintains a set of indexed objects that can be modified with multi-level rollback support
@@ -42,7 +50,7 @@ namespace graphene { namespace db {
          object_database();
          ~object_database();
 
-         void reset_indexes() { _index.clear(); _index.resize(255); }
+         void reset_indexes() { _state_hashes.clear(); _index.clear(); _index.resize(255); }
 
          void open(const fc::path& data_dir );
 
@@ -151,8 +159,32 @@ namespace graphene { namespace db {
 
          void pop_undo();
 
+         /**
+          * Load objects without maintaining the secondary indexes which can be rebuilt afterwards in one pass,
+          * see base_primary_index::begin_bulk_load. Every call must be followed by end_bulk_load(), use
+          * bulk_load_guard to make sure it is.
+          */
+         void begin_bulk_load();
+         void end_bulk_load();
+
+         /**
+          * Maintain the digest of each index from now on, so it can be obtained without scanning the index.
+          * The first call hashes all objects once, subsequent calls do nothing.
+          * @see state_hash_index
+          */
+         void enable_state_hash();
+         bool state_hash_enabled()const { return !_state_hashes.empty(); }
+
+         /// @return the digest of each index by its space and type, requires enable_state_hash()
+         std::map< std::pair<uint8_t,uint8_t>, fc::uint128 > get_index_state_hashes()const;
+         /// @return the digest of all objects, requires enable_state_hash()
+         fc::uint128 get_state_hash()const;
+
          fc::path get_data_dir()const { return _data_dir; }
 
+         /// The numbers of objects created, modified and removed so far, including by undo and by loading
+         const object_change_counts& get_object_change_counts()const { return _object_change_counts; }
+
          /** public for testing purposes only... should be private in practice. */
          undo_database                          _undo_db;
      protected:
@@ -167,6 +199,8 @@ namespace graphene { namespace db {
          index& get_mutable_index(uint8_t space_id, uint8_t type_id);
 
      private:
+         /** call f( space, type, index, primary ) for every index */
+         void for_each_primary_index( const std::function<void(uint8_t,uint8_t,index&,base_primary_index&)>& f );
 
          friend class base_primary_index;
          friend class undo_database;
@@ -175,7 +209,30 @@ namespace graphene { namespace db {
          void save_undo_remove( const object& obj );
 
          fc::path                                                  _data_dir;
+         object_change_counts                                      _object_change_counts;
          vector< vector< unique_ptr<index> > >                     _index;
+         std::map< std::pair<uint8_t,uint8_t>, const state_hash_index* > _state_hashes;
+   };
+
+   /**
+    * Keeps an object database in bulk load mode while it exists, see object_database::begin_bulk_load().
+    * Bulk loading also ends if an exception leaves the scope, so the secondary indexes are maintained again.
+    */
+   class bulk_load_guard
+   {
+      public:
+         explicit bulk_load_guard( object_database& db ) : _db( db ) { _db.begin_bulk_load(); }
+         ~bulk_load_guard();
+
+         bulk_load_guard( const bulk_load_guard& ) = delete;
+         bulk_load_guard& operator = ( const bulk_load_guard& ) = delete;
+
+         /// End bulk loading, passing on any exception of rebuilding the secondary indexes
+         void end();
+
+      private:
+         object_database& _db;
+         bool             _ended = false;
    };
 
 } } // graphene::db
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/db/index.hpp>
+
+#include <boost/container/flat_set.hpp>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace graphene { namespace db {
+
+   /**
+    *  Maps keys to the ids of the objects which reference them. Most keys are referenced by a few objects only, so
+    *  the ids are kept in sorted vectors.
+    */
+   template< typename Key, typename Id, typename Compare = std::less<Key> >
+   using reference_map = std::map< Key, boost::container::flat_set<Id>, Compare >;
+
+   /**
+    *  @brief Maintains a reference_map for a secondary index
+    *
+    *  The keys of an object are obtained from a KeyExtractor, a function object with a key_type typedef which
+    *  appends the keys of an object to a vector, in any order and possibly repeated. A modification of an object
+    *  only applies the difference between its keys before and after, and the whole map can be rebuilt in one pass
+    *  from a primary index.
+    *
+    *  The tracker does not own the map, so an index can keep the map under its own name and maintain several maps.
+    *  The index forwards its secondary_index callbacks to the tracker.
+    */
+   template< typename Object, typename Id, typename KeyExtractor,
+             typename Compare = std::less< typename KeyExtractor::key_type > >
+   class reference_tracker
+   {
+      public:
+         typedef typename KeyExtractor::key_type     key_type;
+         typedef reference_map<key_type, Id, Compare> map_type;
+
+         /**
+          *  @param references the map to maintain
+          *  @param erase_unreferenced whether to remove the keys which are no longer referenced by any object
+          */
+         explicit reference_tracker( map_type& references, bool erase_unreferenced = true )
+            : _references( references ), _erase_unreferenced( erase_unreferenced ) {}
+
+         reference_tracker( const reference_tracker& ) = delete;
+         reference_tracker& operator=( const reference_tracker& ) = delete;
+
+         void inserted( const Object& obj )
+         {
+            extract( obj, _after );
+            for( const key_type& key : _after )
+               _references[key].insert( obj.id );
+         }
+
+         void removed( const Object& obj )
+         {
+            extract( obj, _after );
+            for( const key_type& key : _after )
+               remove( key, obj.id );
+         }
+
+         void about_to_modify( const Object& before )
+         {
+            extract( before, _before );
+         }
+
+         void modified( const Object& after )
+         {
+            extract( after, _after );
+            const auto less = _references.key_comp();
+            auto b = _before.begin();
+            auto a = _after.begin();
+            while( b != _before.end() || a != _after.end() )
+            {
+               if( a == _after.end() || ( b != _before.end() && less( *b, *a ) ) )
+                  remove( *b++, after.id );
+               else if( b == _before.end() || less( *a, *b ) )
+                  _references[*a++].insert( after.id );
+               else // same key before and after
+               {
+                  ++a;
+                  ++b;
+               }
+            }
+         }
+
+         /// Replace the content of the map by the references of all objects of @p primary
+         void rebuild( const index& primary )
+         {
+            std::vector< std::pair<key_type, Id> > references;
+            // objects are visited in ascending order of their ids
+            primary.inspect_all_objects( [this,&references]( const object& obj ) {
+               const Object& o = static_cast<const Object&>( obj );
+               extract( o, _after );
+               for( const key_type& key : _after )
+                  references.emplace_back( key, o.id );
+            } );
+
+            const auto less = _references.key_comp();
+            std::stable_sort( references.begin(), references.end(),
+                              [&less]( const std::pair<key_type, Id>& a, const std::pair<key_type, Id>& b ) {
+                                 return less( a.first, b.first );
+                              } );
+            _references.clear();
+            std::vector<Id> ids;
+            for( auto itr = references.begin(); itr != references.end(); )
+            {
+               ids.clear();
+               auto end = itr;
+               while( end != references.end() && !less( itr->first, end->first ) )
+                  ids.push_back( (end++)->second );
+               _references.emplace_hint( _references.end(), itr->first,
+                                         boost::container::flat_set<Id>( boost::container::ordered_unique_range,
+                                                                          ids.begin(), ids.end() ) );
+               itr = end;
+            }
+         }
+
+      private:
+         /// the keys of an object, sorted and unique
+         void extract( const Object& obj, std::vector<key_type>& keys )const
+         {
+            keys.clear();
+            _extract( obj, keys );
+            const auto less = _references.key_comp();
+            std::sort( keys.begin(), keys.end(), less );
+            keys.erase( std::unique( keys.begin(), keys.end(),
+                                     [&less]( const key_type& a, const key_type& b ) {
+                                        return !less( a, b ) && !less( b, a );
+                                     } ),
+                        keys.end() );
+         }
+
+         void remove( const key_type& key, const Id& id )
+         {
+            auto itr = _references.find( key );
+            if( itr == _references.end() )
+               return;
+            itr->second.erase( id );
+            if( _erase_unreferenced && itr->second.empty() )
+               _references.erase( itr );
+         }
+
+         map_type&              _references;
+         const bool             _erase_unreferenced;
+         KeyExtractor           _extract;
+         /// reused between calls to avoid allocations
+         std::vector<key_type>  _before;
+         std::vector<key_type>  _after;
+   };
+
+} } // graphene::db
@@ -24,6 +24,7 @@
 #pragma once
 #include <graphene/db/object.hpp>
 #include <deque>
+#include <vector>
 #include <fc/exception/exception.hpp>
 
 namespace graphene { namespace db {
@@ -128,9 +129,16 @@ namespace graphene { namespace db {
          void merge();
          void commit();
 
+         /// Push a new undo state, reusing the hash tables of a previously popped one if possible
+         void push_state();
+         /// Pop the top undo state and keep it for reuse by the next session
+         void pop_state();
+
          uint32_t                _active_sessions = 0;
          bool                    _disabled = true;
          std::deque<undo_state>  _stack;
+         /// Cleared undo states whose bucket arrays are kept for the next sessions
+         std::vector<undo_state> _spare_states;
          object_database&        _db;
          size_t                  _max_size = 256;
    };
@@ -40,4 +40,29 @@ namespace graphene { namespace db {
 
    void base_primary_index::on_modify( const object& obj )
    {for( auto ob : _observers ) ob->on_modify(  obj ); }
+
+   void base_primary_index::begin_bulk_load()
+   {
+      FC_ASSERT( !_bulk_loading, "Already bulk loading" );
+      _bulk_loading = true;
+      _notified_sindex.clear();
+      for( const auto& item : _sindex )
+         if( !item->supports_bulk_load() )
+            _notified_sindex.push_back( item.get() );
+   }
+
+   void base_primary_index::end_bulk_load()
+   {
+      FC_ASSERT( _bulk_loading, "Not bulk loading" );
+      const index* primary = dynamic_cast<const index*>( this );
+      FC_ASSERT( primary != nullptr );
+      _bulk_loading = false;
+      _notified_sindex.clear();
+      for( const auto& item : _sindex )
+      {
+         if( item->supports_bulk_load() )
+            item->rebuild( *primary );
+         _notified_sindex.push_back( item.get() );
+      }
+   }
 } } // graphene::chain
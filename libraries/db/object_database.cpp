@@ -24,6 +24,7 @@
 #include <graphene/db/object_database.hpp>
 
 #include <fc/io/raw.hpp>
+#include <fc/optional.hpp>
 #include <fc/container/flat.hpp>
 #include <fc/thread/parallel.hpp>
 #include <fc/uint128.hpp>
@@ -113,6 +114,7 @@ void object_database::open(const fc::path& data_dir)
    std::vector<fc::future<void>> tasks;
    tasks.reserve(200);
    ilog("Opening object database from ${d} ...", ("d", data_dir));
+   bulk_load_guard bulk_load( *this );
    for( uint32_t space = 0; space < _index.size(); ++space )
       for( uint32_t type = 0; type  < _index[space].size(); ++type )
          if( _index[space][type] )
@@ -121,11 +123,108 @@ void object_database::open(const fc::path& data_dir)
             } ) );
    for( auto& task : tasks )
       task.wait();
+   bulk_load.end();
    ilog( "Done opening object database." );
 
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
 
+void object_database::for_each_primary_index(
+      const std::function<void(uint8_t,uint8_t,index&,base_primary_index&)>& f )
+{
+   for( uint32_t space = 0; space < _index.size(); ++space )
+      for( uint32_t type = 0; type < _index[space].size(); ++type )
+      {
+         const auto& idx = _index[space][type];
+         if( !idx )
+            continue;
+         auto primary = dynamic_cast<base_primary_index*>( idx.get() );
+         FC_ASSERT( primary != nullptr, "Index ${s}.${t} does not support secondary indexes",
+                    ("s",space)("t",type) );
+         f( space, type, *idx, *primary );
+      }
+}
+
+void object_database::begin_bulk_load()
+{ try {
+   vector<base_primary_index*> started;
+   try {
+      for_each_primary_index( [&started]( uint8_t, uint8_t, index&, base_primary_index& primary ) {
+         primary.begin_bulk_load();
+         started.push_back( &primary );
+      });
+   } catch( ... ) {
+      // either all indexes are in bulk load mode or none
+      for( base_primary_index* primary : started )
+         primary->end_bulk_load();
+      throw;
+   }
+} FC_CAPTURE_AND_RETHROW() }
+
+void object_database::end_bulk_load()
+{ try {
+   // end bulk loading of every index, even if the secondary indexes of one of them cannot be rebuilt
+   fc::optional<fc::exception> failure;
+   for_each_primary_index( [&failure]( uint8_t, uint8_t, index&, base_primary_index& primary ) {
+      try {
+         primary.end_bulk_load();
+      } catch( const fc::exception& e ) {
+         if( !failure )
+            failure = e;
+      }
+   });
+   if( failure )
+      throw *failure;
+} FC_CAPTURE_AND_RETHROW() }
+
+bulk_load_guard::~bulk_load_guard()
+{
+   if( _ended )
+      return;
+   try {
+      _db.end_bulk_load();
+   }
+   catch ( const fc::exception& e )
+   {
+      elog( "Failed to end bulk loading: ${e}", ("e",e.to_detail_string()) );
+   }
+}
+
+void bulk_load_guard::end()
+{
+   FC_ASSERT( !_ended, "Bulk loading has already ended" );
+   _ended = true;
+   _db.end_bulk_load();
+}
+
+void object_database::enable_state_hash()
+{ try {
+   if( state_hash_enabled() )
+      return;
+   for_each_primary_index( [this]( uint8_t space, uint8_t type, index& idx, base_primary_index& primary ) {
+      const index* indexptr = &idx;
+      _state_hashes[ std::make_pair( space, type ) ] = primary.add_secondary_index<state_hash_index>( indexptr );
+   });
+} FC_CAPTURE_AND_RETHROW() }
+
+std::map< std::pair<uint8_t,uint8_t>, fc::uint128 > object_database::get_index_state_hashes()const
+{
+   FC_ASSERT( state_hash_enabled(), "State hash is not enabled" );
+   std::map< std::pair<uint8_t,uint8_t>, fc::uint128 > result;
+   for( const auto& item : _state_hashes )
+      result.emplace_hint( result.end(), item.first, item.second->hash() );
+   return result;
+}
+
+fc::uint128 object_database::get_state_hash()const
+{
+   FC_ASSERT( state_hash_enabled(), "State hash is not enabled" );
+   fc::uint128 result;
+   for( const auto& item : _state_hashes )
+      result += item.second->hash();
+   return result;
+}
+
 void object_database::pop_undo()
 { try {
    _undo_db.pop_commit();
@@ -133,16 +232,19 @@ void object_database::pop_undo()
 
 void object_database::save_undo( const object& obj )
 {
+   ++_object_change_counts.modified;
    _undo_db.on_modify( obj );
 }
 
 void object_database::save_undo_add( const object& obj )
 {
+   ++_object_change_counts.created;
    _undo_db.on_create( obj );
 }
 
 void object_database::save_undo_remove(const object& obj)
 {
+   ++_object_change_counts.removed;
    _undo_db.on_remove( obj );
 }
 
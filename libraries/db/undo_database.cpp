@@ -30,6 +30,44 @@ namespace graphene { namespace db {
 void undo_database::enable()  { _disabled = false; }
 void undo_database::disable() { _disabled = true; }
 
+namespace {
+   // A session is started for each transaction, most of them touch only a handful of objects. Reusing the
+   // hash tables of finished sessions saves allocating their bucket arrays again. Tables which have grown
+   // large, e.g. from a whole block, are released, as clearing them would cost more than it saves.
+   const size_t max_spare_states = 4;
+   const size_t max_spare_buckets = 256;
+
+   template<typename Map>
+   bool is_small( const Map& m ) { return m.bucket_count() <= max_spare_buckets; }
+}
+
+void undo_database::push_state()
+{
+   if( _spare_states.empty() )
+      _stack.emplace_back();
+   else
+   {
+      _stack.emplace_back( std::move( _spare_states.back() ) );
+      _spare_states.pop_back();
+   }
+}
+
+void undo_database::pop_state()
+{
+   undo_state& state = _stack.back();
+   if( _spare_states.size() < max_spare_states
+         && is_small( state.old_values ) && is_small( state.old_index_next_ids )
+         && is_small( state.new_ids ) && is_small( state.removed ) )
+   {
+      state.old_values.clear();
+      state.old_index_next_ids.clear();
+      state.new_ids.clear();
+      state.removed.clear();
+      _spare_states.emplace_back( std::move( state ) );
+   }
+   _stack.pop_back();
+}
+
 undo_database::session::~session()
 {
    try {
@@ -53,7 +91,7 @@ undo_database::session undo_database::start_undo_session( bool force_enable )
    while( size() > max_size() )
       _stack.pop_front();
 
-   _stack.emplace_back();
+   push_state();
    ++_active_sessions;
    return session(*this, disable_on_exit );
 }
@@ -62,7 +100,7 @@ void undo_database::on_create( const object& obj )
    if( _disabled ) return;
 
    if( _stack.empty() )
-      _stack.emplace_back();
+      push_state();
    auto& state = _stack.back();
    auto index_id = object_id_type( obj.id.space(), obj.id.type(), 0 );
    auto itr = state.old_index_next_ids.find( index_id );
@@ -75,7 +113,7 @@ void undo_database::on_modify( const object& obj )
    if( _disabled ) return;
 
    if( _stack.empty() )
-      _stack.emplace_back();
+      push_state();
    auto& state = _stack.back();
    if( state.new_ids.find(obj.id) != state.new_ids.end() )
       return;
@@ -88,7 +126,7 @@ void undo_database::on_remove( const object& obj )
    if( _disabled ) return;
 
    if( _stack.empty() )
-      _stack.emplace_back();
+      push_state();
    undo_state& state = _stack.back();
    if( state.new_ids.count(obj.id) )
    {
@@ -130,7 +168,7 @@ void undo_database::undo()
    for( auto& item : state.removed )
       _db.insert( std::move(*item.second) );
 
-   _stack.pop_back();
+   pop_state();
    enable();
    --_active_sessions;
 } FC_CAPTURE_AND_RETHROW() }
@@ -140,7 +178,7 @@ void undo_database::merge()
    FC_ASSERT( _active_sessions > 0 );
    if( _active_sessions == 1 && _stack.size() == 1 )
    {
-      _stack.pop_back();
+      pop_state();
       --_active_sessions;
       return;
    }
@@ -252,7 +290,7 @@ void undo_database::merge()
       // nop + del(was=Y) -> del(was=Y)
       prev_state.removed[obj.second->id] = std::move(obj.second);
    }
-   _stack.pop_back();
+   pop_state();
    --_active_sessions;
 }
 void undo_database::commit()
@@ -288,7 +326,7 @@ void undo_database::pop_commit()
       for( auto& item : state.removed )
          _db.insert( std::move(*item.second) );
 
-      _stack.pop_back();
+      pop_state();
    }
    catch ( const fc::exception& e )
    {
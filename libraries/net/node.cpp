@@ -2247,6 +2247,15 @@ namespace graphene { namespace net { namespace detail {
       return item_not_available_message(item);
     }
 
+    /// A packed block_message ends with the id of the block, read it without unpacking the block
+    static block_id_type block_id_of_block_message( const message& msg )
+    {
+      FC_ASSERT( msg.msg_type.value() == block_message_type && msg.data.size() >= sizeof(block_id_type) );
+      block_id_type result;
+      memcpy( result._hash, msg.data.data() + msg.data.size() - sizeof(result), sizeof(result) );
+      return result;
+    }
+
     void node_impl::on_fetch_items_message(peer_connection* originating_peer, const fetch_items_message& fetch_items_message_received)
     {
       VERIFY_CORRECT_THREAD();
@@ -2300,15 +2309,15 @@ namespace graphene { namespace net { namespace detail {
       // if we sent them a block, update our record of the last block they've seen accordingly
       if (last_block_message_sent)
       {
-        graphene::net::block_message block = last_block_message_sent->as<graphene::net::block_message>();
-        originating_peer->last_block_delegate_has_seen = block.block_id;
-        originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(block.block_id);
+        block_id_type block_id = block_id_of_block_message( *last_block_message_sent );
+        originating_peer->last_block_delegate_has_seen = block_id;
+        originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(block_id);
       }
 
       for (const message& reply : reply_messages)
       {
         if (reply.msg_type.value() == block_message_type)
-          originating_peer->send_item(item_id(block_message_type, reply.as<graphene::net::block_message>().block_id));
+          originating_peer->send_item(item_id(block_message_type, block_id_of_block_message(reply)));
         else
           originating_peer->send_message(reply);
       }
@@ -8,6 +8,7 @@
 #include <graphene/chain/block_database.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/witness_object.hpp>
+#include <graphene/chain/witness_schedule_object.hpp>
 
 #include <graphene/utilities/key_conversion.hpp>
 
@@ -28,6 +29,9 @@ class debug_api_impl
       void debug_update_object( const fc::variant_object& update );
       void debug_stream_json_objects( const std::string& filename );
       void debug_stream_json_objects_flush();
+      fc::variant_object debug_get_state_hash();
+      void debug_profile_operations( bool enabled );
+      std::vector< graphene::chain::operation_profile > debug_get_operation_profile( bool reset );
       std::shared_ptr< graphene::debug_witness_plugin::debug_witness_plugin > get_plugin();
 
       graphene::app::application& app;
@@ -84,9 +88,10 @@ void debug_api_impl::debug_generate_blocks( const std::string& debug_key, uint32
    std::shared_ptr< graphene::chain::database > db = app.chain_database();
    for( uint32_t i=0; i<count; i++ )
    {
-      graphene::chain::witness_id_type scheduled_witness = db->get_scheduled_witness( 1 );
-      fc::time_point_sec scheduled_time = db->get_slot_time( 1 );
-      graphene::chain::public_key_type scheduled_key = scheduled_witness( *db ).signing_key;
+      const auto schedule = db->get_witness_schedule_table();
+      graphene::chain::witness_id_type scheduled_witness = schedule->get_scheduled_witness( 1 );
+      fc::time_point_sec scheduled_time = schedule->get_slot_time( 1 );
+      const graphene::chain::public_key_type& scheduled_key = schedule->get_scheduled_signing_key( 1 );
       if( scheduled_key != debug_public_key )
       {
          ilog( "Modified key for witness ${w}", ("w", scheduled_witness) );
@@ -119,6 +124,42 @@ void debug_api_impl::debug_stream_json_objects_flush()
    get_plugin()->flush_json_object_stream();
 }
 
+fc::variant_object debug_api_impl::debug_get_state_hash()
+{
+   std::shared_ptr< graphene::chain::database > db = app.chain_database();
+   if( !db->state_hash_enabled() )
+   {
+      ilog( "Computing the state hash of all indexes, it is maintained incrementally from now on" );
+      db->enable_state_hash();
+   }
+
+   fc::mutable_variant_object indexes;
+   for( const auto& item : db->get_index_state_hashes() )
+      indexes( fc::to_string( item.first.first ) + "." + fc::to_string( item.first.second ),
+               fc::variant( item.second, 1 ) );
+
+   fc::mutable_variant_object result;
+   result( "head_block_num", db->head_block_num() )
+         ( "head_block_id", db->head_block_id() )
+         ( "state_hash", fc::variant( db->get_state_hash(), 1 ) )
+         ( "indexes", indexes );
+   return result;
+}
+
+void debug_api_impl::debug_profile_operations( bool enabled )
+{
+   app.chain_database()->get_operation_profiler().enable( enabled );
+}
+
+std::vector< graphene::chain::operation_profile > debug_api_impl::debug_get_operation_profile( bool reset )
+{
+   graphene::chain::operation_profiler& profiler = app.chain_database()->get_operation_profiler();
+   std::vector< graphene::chain::operation_profile > result = profiler.get_profile();
+   if( reset )
+      profiler.reset();
+   return result;
+}
+
 } // detail
 
 debug_api::debug_api( graphene::app::application& app )
@@ -151,5 +192,19 @@ void debug_api::debug_stream_json_objects_flush()
    my->debug_stream_json_objects_flush();
 }
 
+fc::variant_object debug_api::debug_get_state_hash()
+{
+   return my->debug_get_state_hash();
+}
+
+void debug_api::debug_profile_operations( bool enabled )
+{
+   my->debug_profile_operations( enabled );
+}
+
+std::vector< graphene::chain::operation_profile > debug_api::debug_get_operation_profile( bool reset )
+{
+   return my->debug_get_operation_profile( reset );
+}
 
 } } // graphene::debug_witness
@@ -48,7 +48,11 @@ void debug_witness_plugin::plugin_set_program_options(
    command_line_options.add_options()
          ("debug-private-key", bpo::value<vector<string>>()->composing()->multitoken()->
           DEFAULT_VALUE_VECTOR(std::make_pair(chain::public_key_type(default_priv_key.get_public_key()), graphene::utilities::key_to_wif(default_priv_key))),
-          "Tuple of [PublicKey, WIF private key] (may specify multiple times)");
+          "Tuple of [PublicKey, WIF private key] (may specify multiple times)")
+         ("debug-state-hash", bpo::bool_switch()->default_value(false),
+          "Maintain the digest of the object database from startup, see debug_get_state_hash")
+         ("debug-profile-operations", bpo::bool_switch()->default_value(false),
+          "Profile the evaluation of operations from startup, including a replay, see debug_get_operation_profile");
    config_file_options.add(command_line_options);
 }
 
@@ -86,6 +90,10 @@ void debug_witness_plugin::plugin_initialize(const boost::program_options::varia
          _private_keys[key_id_to_wif_pair.first] = *private_key;
       }
    }
+   _maintain_state_hash = options.count("debug-state-hash") && options["debug-state-hash"].as<bool>();
+   // enabled before the database is opened, so that a replay is profiled and its profile logged at its end
+   if( options.count("debug-profile-operations") && options["debug-profile-operations"].as<bool>() )
+      database().get_operation_profiler().enable( true );
    ilog("debug_witness plugin:  plugin_initialize() end");
 } FC_LOG_AND_RETHROW() }
 
@@ -94,6 +102,12 @@ void debug_witness_plugin::plugin_startup()
    ilog("debug_witness_plugin::plugin_startup() begin");
    chain::database& db = database();
 
+   if( _maintain_state_hash )
+   {
+      ilog( "Computing the state hash of all indexes" );
+      db.enable_state_hash();
+   }
+
    // connect needed signals
 
    _applied_block_conn  = db.applied_block.connect([this](const graphene::chain::signed_block& b){ on_applied_block(b); });
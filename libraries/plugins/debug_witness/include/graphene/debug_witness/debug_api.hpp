@@ -25,10 +25,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <fc/api.hpp>
 #include <fc/variant_object.hpp>
 
+#include <graphene/chain/operation_profiler.hpp>
+
 namespace graphene { namespace app {
 class application;
 } }
@@ -82,6 +85,27 @@ class debug_api
        */
       void debug_stream_json_objects_flush();
 
+      /**
+       * Get the digest of the object database at the head block, in total and per index.
+       * Nodes in the same state report the same digests, comparing the per index digests shows where they differ.
+       * The digests are maintained incrementally, the first call enables this unless the debug-state-hash option
+       * has been set and therefore scans the whole database once.
+       */
+      fc::variant_object debug_get_state_hash();
+
+      /**
+       * Start or stop profiling the evaluation of operations, the statistics collected so far are kept.
+       * Profiling can also be enabled from startup with the debug-profile-operations option.
+       */
+      void debug_profile_operations( bool enabled );
+
+      /**
+       * Get the call counts, times in nanoseconds and object changes of the operations applied while profiling,
+       * by operation type and evaluation stage.
+       * @param reset whether to clear the statistics afterwards
+       */
+      std::vector< graphene::chain::operation_profile > debug_get_operation_profile( bool reset );
+
       std::shared_ptr< detail::debug_api_impl > my;
 };
 
@@ -93,4 +117,7 @@ FC_API(graphene::debug_witness::debug_api,
        (debug_update_object)
        (debug_stream_json_objects)
        (debug_stream_json_objects_flush)
+       (debug_get_state_hash)
+       (debug_profile_operations)
+       (debug_get_operation_profile)
      )
@@ -57,6 +57,7 @@ private:
    void on_applied_block( const graphene::chain::signed_block& b );
 
    boost::program_options::variables_map _options;
+   bool _maintain_state_hash = false;
 
    std::map<chain::public_key_type, fc::ecc::private_key, chain::pubkey_comparator> _private_keys;
 
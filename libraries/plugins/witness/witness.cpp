@@ -25,6 +25,7 @@
 
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/witness_object.hpp>
+#include <graphene/chain/witness_schedule_object.hpp>
 
 #include <graphene/utilities/key_conversion.hpp>
 
@@ -275,21 +276,22 @@ block_production_condition::block_production_condition_enum witness_plugin::mayb
    chain::database& db = database();
    fc::time_point now_fine = fc::time_point::now();
    fc::time_point_sec now = now_fine + fc::microseconds( 500000 );
+   const auto schedule = db.get_witness_schedule_table();
 
    // If the next block production opportunity is in the present or future, we're synced.
    if( !_production_enabled )
    {
-      if( db.get_slot_time(1) >= now )
+      if( schedule->get_slot_time(1) >= now )
          _production_enabled = true;
       else
          return block_production_condition::not_synced;
    }
 
    // is anyone scheduled to produce now or one second in the future?
-   uint32_t slot = db.get_slot_at_time( now );
+   uint32_t slot = schedule->get_slot_at_time( now );
    if( slot == 0 )
    {
-      capture("next_time", db.get_slot_time(1));
+      capture("next_time", schedule->get_slot_time(1));
       return block_production_condition::not_time_yet;
    }
 
@@ -303,7 +305,7 @@ block_production_condition::block_production_condition_enum witness_plugin::mayb
    //
    assert( now > db.head_block_time() );
 
-   graphene::chain::witness_id_type scheduled_witness = db.get_scheduled_witness( slot );
+   graphene::chain::witness_id_type scheduled_witness = schedule->get_scheduled_witness( slot );
    // we must control the witness scheduled to produce the next block.
    if( _witnesses.find( scheduled_witness ) == _witnesses.end() )
    {
@@ -311,7 +313,7 @@ block_production_condition::block_production_condition_enum witness_plugin::mayb
       return block_production_condition::not_my_turn;
    }
 
-   fc::time_point_sec scheduled_time = db.get_slot_time( slot );
+   fc::time_point_sec scheduled_time = schedule->get_slot_time( slot );
    graphene::chain::public_key_type scheduled_key = *_witness_key_cache[scheduled_witness]; // should be valid
    auto private_key_itr = _private_keys.find( scheduled_key );
 
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/protocol/authority_cache.hpp>
+
+#include <cstring>
+
+namespace graphene { namespace protocol {
+
+const size_t authority_cache::default_capacity;
+
+authority_cache::authority_cache( version_getter get_version, size_t capacity )
+   : _get_version( std::move(get_version) ), _capacity( capacity )
+{}
+
+size_t authority_cache::cache_key_hash::operator()( const cache_key& key )const
+{
+   uint64_t result = key.account.instance.value * 0x9e3779b97f4a7c15ULL;
+   for( const public_key_type& k : key.keys )
+   {
+      // skip the prefix byte, the x coordinate is uniformly distributed
+      uint64_t x;
+      memcpy( &x, k.key_data.begin() + 1, sizeof(x) );
+      result = ( result ^ x ) * 0x100000001b3ULL;
+   }
+   return static_cast<size_t>( result ^ ( uint64_t(key.max_recursion) << 1 ) ^ key.allow_non_immediate_owner );
+}
+
+const authority_cache::outcome* authority_cache::find( account_id_type account, const flat_set<public_key_type>& keys,
+                                                      bool allow_non_immediate_owner, uint32_t max_recursion )
+{
+   auto itr = _outcomes.find( cache_key{ account, keys, allow_non_immediate_owner, max_recursion } );
+   if( itr != _outcomes.end() )
+   {
+      bool current = true;
+      for( const auto& v : itr->second.authority_versions )
+      {
+         if( _get_version( v.first ) != v.second )
+         {
+            current = false;
+            break;
+         }
+      }
+      if( current )
+      {
+         ++_hits;
+         return &itr->second;
+      }
+   }
+   ++_misses;
+   return nullptr;
+}
+
+void authority_cache::store( account_id_type account, const flat_set<public_key_type>& keys,
+                             bool allow_non_immediate_owner, uint32_t max_recursion,
+                             bool satisfied, flat_set<public_key_type> used_keys, flat_set<account_id_type> approved,
+                             const flat_set<account_id_type>& consulted )
+{
+   if( _capacity == 0 )
+      return;
+
+   outcome o;
+   o.satisfied = satisfied;
+   o.used_keys = std::move( used_keys );
+   o.approved = std::move( approved );
+   o.authority_versions.reserve( consulted.size() );
+   for( const account_id_type& id : consulted )
+      o.authority_versions.emplace_back( id, _get_version( id ) );
+
+   auto result = _outcomes.emplace( cache_key{ account, keys, allow_non_immediate_owner, max_recursion },
+                                    outcome() );
+   result.first->second = std::move( o );
+   if( result.second )
+   {
+      _insertion_order.push_back( &result.first->first );
+      evict( _capacity );
+   }
+}
+
+void authority_cache::evict( size_t max_size )
+{
+   while( _outcomes.size() > max_size )
+   {
+      // look the entry up first, the key being erased must not be passed by reference to erase()
+      _outcomes.erase( _outcomes.find( *_insertion_order.front() ) );
+      _insertion_order.pop_front();
+   }
+}
+
+void authority_cache::set_capacity( size_t capacity )
+{
+   _capacity = capacity;
+   evict( _capacity );
+}
+
+void authority_cache::clear()
+{
+   _outcomes.clear();
+   _insertion_order.clear();
+   _hits = 0;
+   _misses = 0;
+}
+
+} } // graphene::protocol
@@ -24,6 +24,8 @@
 #include <boost/endian/conversion.hpp>
 #include <graphene/protocol/block.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
+#include <graphene/protocol/pack_stream.hpp>
+#include <graphene/protocol/sha256_batch.hpp>
 #include <fc/io/raw.hpp>
 #include <algorithm>
 
@@ -75,29 +77,90 @@ namespace graphene { namespace protocol {
 
       if( !_calculated_merkle_root._hash[0].value() )
       {
-         vector<digest_type> ids;
-         ids.resize( transactions.size() );
-         for( uint32_t i = 0; i < transactions.size(); ++i )
-            ids[i] = transactions[i].merkle_digest();
+         static_assert( sizeof(digest_type) == 32, "a pair of digests must be a contiguous 64 byte message" );
 
-         vector<digest_type>::size_type current_number_of_hashes = ids.size();
-         while( current_number_of_hashes > 1 )
+         // pack all transactions into one buffer and hash them together, see merkle_digest()
+         vector<char>& packed = thread_pack_buffer();
+         vector_stream stream( packed );
+         vector<size_t> ends( transactions.size() );
+         for( uint32_t i = 0; i < transactions.size(); ++i )
          {
-            // hash ID's in pairs
-            uint32_t i_max = current_number_of_hashes - (current_number_of_hashes&1);
-            uint32_t k = 0;
+            fc::raw::pack( stream, transactions[i] );
+            ends[i] = packed.size();
+         }
+         vector<sha256_message> messages( transactions.size() );
+         for( size_t i = 0, start = 0; i < transactions.size(); start = ends[i++] )
+            messages[i] = { packed.data() + start, ends[i] - start };
 
-            for( uint32_t i = 0; i < i_max; i += 2 )
-               ids[k++] = digest_type::hash( std::make_pair( ids[i], ids[i+1] ) );
+         vector<digest_type> ids( transactions.size() );
+         sha256_batch( messages.data(), messages.size(), ids.data() );
 
-            if( current_number_of_hashes&1 )
-               ids[k++] = ids[i_max];
-            current_number_of_hashes = k;
+         vector<digest_type> next_ids;
+         while( ids.size() > 1 )
+         {
+            // hash ID's in pairs, a packed pair is the concatenation of the two digests
+            const size_t pairs = ids.size() / 2;
+            for( size_t i = 0; i < pairs; ++i )
+               messages[i] = { reinterpret_cast<const char*>( &ids[2*i] ), 2 * sizeof(digest_type) };
+            next_ids.resize( pairs + ( ids.size() & 1 ) );
+            sha256_batch( messages.data(), pairs, next_ids.data() );
+
+            if( ids.size() & 1 )
+               next_ids.back() = ids.back();
+            std::swap( ids, next_ids );
          }
          _calculated_merkle_root = checksum_type::hash( ids[0] );
       }
       return _calculated_merkle_root;
    }
+
+   signed_block_view::signed_block_view( vector<char> packed )
+      : _packed( std::move(packed) )
+   {
+      fc::datastream<const char*> ds( _packed.data(), _packed.size() );
+      fc::raw::unpack( ds, _header );
+      fc::unsigned_int count;
+      fc::raw::unpack( ds, count );
+      // every transaction takes more than one byte
+      FC_ASSERT( count.value <= size_t( ds.remaining() ), "Invalid number of transactions in packed block" );
+      _transaction_count = count.value;
+      _transaction_offsets.push_back( _packed.size() - ds.remaining() );
+   }
+
+   signed_block_view::signed_block_view( const signed_block& block )
+      : signed_block_view( fc::raw::pack( block ) )
+   {}
+
+   size_t signed_block_view::transaction_offset( size_t index )const
+   {
+      if( index >= _transaction_offsets.size() )
+      {
+         processed_transaction skipped;
+         fc::datastream<const char*> ds( _packed.data(), _packed.size() );
+         ds.skip( _transaction_offsets.back() );
+         while( _transaction_offsets.size() <= index )
+         {
+            fc::raw::unpack( ds, skipped );
+            _transaction_offsets.push_back( _packed.size() - ds.remaining() );
+         }
+      }
+      return _transaction_offsets[index];
+   }
+
+   processed_transaction signed_block_view::transaction( size_t index )const
+   {
+      FC_ASSERT( index < _transaction_count, "Transaction ${i} not in block", ("i",index) );
+      fc::datastream<const char*> ds( _packed.data(), _packed.size() );
+      ds.skip( transaction_offset( index ) );
+      processed_transaction result;
+      fc::raw::unpack( ds, result );
+      return result;
+   }
+
+   signed_block signed_block_view::block()const
+   {
+      return fc::raw::unpack<signed_block>( _packed );
+   }
 } }
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::block_header)
@@ -23,6 +23,7 @@
  */
 #include <algorithm>
 #include <graphene/protocol/fee_schedule.hpp>
+#include <graphene/protocol/variant_dispatch.hpp>
 
 #include <fc/io/raw.hpp>
 
@@ -117,9 +118,8 @@ namespace graphene { namespace protocol {
       this->scale = 0;
    }
 
-   asset fee_schedule::calculate_fee( const operation& op )const
+   static asset scale_fee( uint64_t required_fee, uint32_t scale )
    {
-      uint64_t required_fee = op.visit( calc_fee_visitor( *this, op ) );
       if( scale != GRAPHENE_100_PERCENT )
       {
          auto scaled = fc::uint128(required_fee) * scale;
@@ -131,19 +131,15 @@ namespace graphene { namespace protocol {
       return asset( required_fee );
    }
 
-   asset fee_schedule::calculate_fee( const operation& op, const price& core_exchange_rate )const
-   {
-      return calculate_fee( op ).multiply_and_round_up( core_exchange_rate );
-   }
-
-   asset fee_schedule::set_fee( operation& op, const price& core_exchange_rate )const
+   template<typename Schedule>
+   static asset set_stable_fee( const Schedule& schedule, operation& op, const price& core_exchange_rate )
    {
-      auto f = calculate_fee( op, core_exchange_rate );
+      auto f = schedule.calculate_fee( op, core_exchange_rate );
       auto f_max = f;
       for( int i=0; i<MAX_FEE_STABILIZATION_ITERATION; i++ )
       {
-         op.visit( set_fee_visitor( f_max ) );
-         auto f2 = calculate_fee( op, core_exchange_rate );
+         dispatch( op, set_fee_visitor( f_max ) );
+         auto f2 = schedule.calculate_fee( op, core_exchange_rate );
          if( f == f2 )
             break;
          f_max = std::max( f_max, f2 );
@@ -158,6 +154,82 @@ namespace graphene { namespace protocol {
       return f_max;
    }
 
+   asset fee_schedule::calculate_fee( const operation& op )const
+   {
+      return scale_fee( dispatch( op, calc_fee_visitor( *this, op ) ), scale );
+   }
+
+   asset fee_schedule::calculate_fee( const operation& op, const price& core_exchange_rate )const
+   {
+      return calculate_fee( op ).multiply_and_round_up( core_exchange_rate );
+   }
+
+   asset fee_schedule::set_fee( operation& op, const price& core_exchange_rate )const
+   {
+      return set_stable_fee( *this, op, core_exchange_rate );
+   }
+
+   /// Resolves the parameters of an operation type the same way @ref calc_fee_visitor does
+   struct resolve_fee_parameters_visitor
+   {
+      typedef fee_parameters result_type;
+
+      const fee_schedule& schedule;
+      resolve_fee_parameters_visitor( const fee_schedule& s ):schedule(s){}
+
+      template<typename OpType>
+      result_type operator()( const OpType& )const
+      {
+         try {
+            return schedule.get<OpType>();
+         } catch (fc::assert_exception& e) {
+            return typename OpType::fee_parameters_type();
+         }
+      }
+   };
+
+   struct fee_table::calc_fee_visitor
+   {
+      typedef uint64_t result_type;
+
+      const fee_table& table;
+      calc_fee_visitor( const fee_table& t ):table(t){}
+
+      template<typename OpType>
+      result_type operator()( const OpType& op )const
+      {
+         return op.calculate_fee( table.get<OpType>() ).value;
+      }
+   };
+
+   fee_table::fee_table( const fee_schedule& schedule )
+   : _scale( schedule.scale )
+   {
+      operation op;
+      const int count = op.count();
+      _parameters.reserve( count );
+      for( int i = 0; i < count; ++i )
+      {
+         op.set_which( i );
+         _parameters.push_back( dispatch( op, resolve_fee_parameters_visitor( schedule ) ) );
+      }
+   }
+
+   asset fee_table::calculate_fee( const operation& op )const
+   {
+      return scale_fee( dispatch( op, calc_fee_visitor( *this ) ), _scale );
+   }
+
+   asset fee_table::calculate_fee( const operation& op, const price& core_exchange_rate )const
+   {
+      return calculate_fee( op ).multiply_and_round_up( core_exchange_rate );
+   }
+
+   asset fee_table::set_fee( operation& op, const price& core_exchange_rate )const
+   {
+      return set_stable_fee( *this, op, core_exchange_rate );
+   }
+
    void chain_parameters::validate()const
    {
       get_current_fees().validate();
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/protocol/authority.hpp>
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+namespace graphene { namespace protocol {
+
+   /**
+    *  @brief A bounded cache of account authorization outcomes
+    *
+    *  Checking whether a set of keys satisfies the authority of an account walks the authorities of all the accounts
+    *  it (recursively) refers to, and derives several addresses per key for the address authorities. Accounts which
+    *  send many transactions sign them with the same keys, so the outcome is the same until one of the authorities
+    *  involved changes.
+    *
+    *  An outcome is keyed by the account, the set of provided keys and the check parameters, and stores the version
+    *  of every authority consulted to produce it. The versions are obtained through a callback supplied by the owner
+    *  of the authorities, which must return a different number whenever the owner or active authority of an account
+    *  changes. An outcome is only used while all of the versions it was computed with are still current.
+    *
+    *  The cache is not thread safe.
+    */
+   class authority_cache
+   {
+   public:
+      typedef std::function<uint64_t(account_id_type)> version_getter;
+
+      /// The result of checking the authority of an account from a state in which nothing has been approved yet
+      struct outcome
+      {
+         /// whether the account is authorized
+         bool                                satisfied = false;
+         /// the provided keys which were used by the check
+         flat_set<public_key_type>           used_keys;
+         /// the accounts whose authorities were found to be satisfied during the check
+         flat_set<account_id_type>           approved;
+         /// the accounts whose authorities were consulted, with their versions
+         vector<pair<account_id_type,uint64_t>> authority_versions;
+      };
+
+      explicit authority_cache( version_getter get_version, size_t capacity = default_capacity );
+
+      /**
+       * @return the cached outcome of checking the authority of @p account against @p keys, or nullptr if there is
+       *         none or it is outdated. The pointer is valid until the next call to a non-const member.
+       */
+      const outcome* find( account_id_type account, const flat_set<public_key_type>& keys,
+                           bool allow_non_immediate_owner, uint32_t max_recursion );
+
+      /// Store the outcome of a check, @p consulted are the accounts whose authorities were looked up
+      void store( account_id_type account, const flat_set<public_key_type>& keys,
+                  bool allow_non_immediate_owner, uint32_t max_recursion,
+                  bool satisfied, flat_set<public_key_type> used_keys, flat_set<account_id_type> approved,
+                  const flat_set<account_id_type>& consulted );
+
+      /// Set the maximum number of cached outcomes, 0 disables caching. Excess entries are evicted.
+      void   set_capacity( size_t capacity );
+      size_t capacity()const { return _capacity; }
+      size_t size()const     { return _outcomes.size(); }
+      void   clear();
+
+      uint64_t hits()const   { return _hits; }
+      uint64_t misses()const { return _misses; }
+
+      static const size_t default_capacity = 16384;
+
+   private:
+      struct cache_key
+      {
+         account_id_type            account;
+         flat_set<public_key_type>  keys;
+         bool                       allow_non_immediate_owner;
+         uint32_t                   max_recursion;
+
+         bool operator == ( const cache_key& other )const
+         {
+            return account == other.account && max_recursion == other.max_recursion
+                && allow_non_immediate_owner == other.allow_non_immediate_owner && keys == other.keys;
+         }
+      };
+
+      struct cache_key_hash
+      {
+         size_t operator()( const cache_key& key )const;
+      };
+
+      void evict( size_t max_size );
+
+      version_getter                                          _get_version;
+      size_t                                                  _capacity;
+      uint64_t                                                _hits = 0;
+      uint64_t                                                _misses = 0;
+      std::unordered_map<cache_key, outcome, cache_key_hash>  _outcomes;
+      /// keys of _outcomes, oldest first; references to unordered_map elements stay valid until they are erased
+      std::deque<const cache_key*>                            _insertion_order;
+   };
+
+} } // graphene::protocol
@@ -65,6 +65,44 @@ namespace graphene { namespace protocol {
       mutable checksum_type   _calculated_merkle_root;
    };
 
+   /**
+    *  @brief A read-only view of a packed @ref signed_block which decodes its parts on demand
+    *
+    *  Only the header is decoded when the view is created. Transactions are decoded one at a time when they are
+    *  accessed, so reading the header or a single transaction of a stored block does not materialize the other
+    *  transactions, and the packed bytes can be forwarded as they are.
+    *
+    *  The packed format has no length prefixes for transactions, so the offset of a transaction is found by
+    *  parsing the transactions before it. The offsets found are remembered.
+    */
+   class signed_block_view
+   {
+   public:
+      /// @throws fc::exception if the header can not be decoded
+      explicit signed_block_view( vector<char> packed );
+      explicit signed_block_view( const signed_block& block );
+
+      const vector<char>&         packed()const { return _packed; }
+      const signed_block_header&  header()const { return _header; }
+      const block_id_type&        id()const     { return _header.id(); }
+      uint32_t                    block_num()const { return _header.block_num(); }
+
+      size_t                      transaction_count()const { return _transaction_count; }
+      /// Decode the transaction at @p index, which must be less than transaction_count()
+      processed_transaction       transaction( size_t index )const;
+      /// Decode the whole block
+      signed_block                block()const;
+
+   private:
+      size_t transaction_offset( size_t index )const;
+
+      vector<char>                _packed;
+      signed_block_header         _header;
+      size_t                      _transaction_count = 0;
+      /// offsets of the transactions in _packed which are known so far, the first one is always known
+      mutable vector<size_t>      _transaction_offsets;
+   };
+
 } } // graphene::protocol
 
 FC_REFLECT( graphene::protocol::block_header, (previous)(timestamp)(witness)(transaction_merkle_root)(extensions) )
@@ -207,6 +207,45 @@ namespace graphene { namespace protocol {
 
    typedef fee_schedule fee_schedule_type;
 
+   /**
+    *  @brief A fee schedule flattened into a table indexed by operation type
+    *
+    *  Looking up the parameters of an operation in a @ref fee_schedule is a binary search, and the parameters
+    *  of some operation types fall back to those of other types or to defaults. The table resolves all of that
+    *  once when it is built, so calculating a fee only indexes an array and evaluates the size-dependent part.
+    *
+    *  The table is a snapshot, it does not follow later changes of the schedule it was built from.
+    */
+   class fee_table
+   {
+   public:
+      explicit fee_table( const fee_schedule& schedule );
+
+      /// @see fee_schedule::calculate_fee
+      asset calculate_fee( const operation& op )const;
+      /// @see fee_schedule::calculate_fee
+      asset calculate_fee( const operation& op, const price& core_exchange_rate )const;
+      /// @see fee_schedule::set_fee
+      asset set_fee( operation& op, const price& core_exchange_rate = price::unit_price() )const;
+
+      /// The fee parameters used for operations of the given type
+      template<typename Operation>
+      const typename Operation::fee_parameters_type& get()const
+      {
+         return _parameters[ operation::tag<Operation>::value ]
+                   .template get<typename Operation::fee_parameters_type>();
+      }
+
+      uint32_t scale()const { return _scale; }
+
+   private:
+      struct calc_fee_visitor;
+
+      /// the resolved parameters of each operation type, indexed by operation::which()
+      vector<fee_parameters> _parameters;
+      uint32_t               _scale;
+   };
+
 } } // graphene::protocol
 
 FC_REFLECT_TYPENAME( graphene::protocol::fee_parameters )
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/protocol/types.hpp>
+
+#include <array>
+
+namespace graphene { namespace protocol {
+
+   /**
+    *  @brief A stream appending everything packed into it to a vector
+    *
+    *  Packing into a preallocated buffer needs a pack_size() walk over the structure first, packing into this
+    *  stream walks it once. Reusing the vector for several objects avoids growing it again.
+    */
+   class vector_stream
+   {
+   public:
+      explicit vector_stream( vector<char>& buffer ) : _buffer( buffer ) {}
+
+      bool write( const char* data, size_t size )
+      {
+         _buffer.insert( _buffer.end(), data, data + size );
+         return true;
+      }
+      bool put( char c )
+      {
+         _buffer.push_back( c );
+         return true;
+      }
+      size_t tellp()const { return _buffer.size(); }
+
+   private:
+      vector<char>& _buffer;
+   };
+
+   /**
+    *  @brief A stream feeding everything packed into it to several hash encoders, counting the bytes
+    *
+    *  This computes the digests of the same packed data behind different prefixes, which are written to the
+    *  encoders directly beforehand, and the packed size in a single walk without buffering the data.
+    *  Null encoders are skipped.
+    */
+   template<typename Encoder, size_t N>
+   class digest_stream
+   {
+   public:
+      explicit digest_stream( const std::array<Encoder*, N>& encoders ) : _encoders( encoders ) {}
+
+      bool write( const char* data, size_t size )
+      {
+         for( Encoder* e : _encoders )
+            if( e != nullptr )
+               e->write( data, size );
+         _size += size;
+         return true;
+      }
+      bool put( char c ) { return write( &c, 1 ); }
+      size_t size()const { return _size; }
+
+   private:
+      std::array<Encoder*, N> _encoders;
+      size_t                  _size = 0;
+   };
+
+   /**
+    *  @return an empty buffer for temporary packing into a @ref vector_stream, owned by the calling thread
+    *  @note the buffer is reused by the next call on the same thread, so it must not be held across calls which
+    *        may use it too. Buffers grown beyond 4 MiB are released instead of being kept.
+    */
+   inline vector<char>& thread_pack_buffer()
+   {
+      static thread_local vector<char> buffer;
+      if( buffer.capacity() > 4 * 1024 * 1024 )
+         vector<char>().swap( buffer );
+      else
+         buffer.clear();
+      return buffer;
+   }
+
+} } // graphene::protocol
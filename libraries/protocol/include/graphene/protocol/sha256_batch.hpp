@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <fc/crypto/sha256.hpp>
+
+#include <cstddef>
+
+namespace graphene { namespace protocol {
+
+   /// A message to be hashed by @ref sha256_batch
+   struct sha256_message
+   {
+      const char* data;
+      size_t      size;
+   };
+
+   /// The implementations of @ref sha256_batch
+   enum class sha256_kernel
+   {
+      scalar, ///< one message at a time through fc::sha256
+      avx2,   ///< eight messages at a time in AVX2 registers
+      sha_ni  ///< one message at a time with the SHA extensions of x86 processors
+   };
+
+   /// @return whether the given kernel can be used on this machine
+   bool          sha256_kernel_supported( sha256_kernel kernel );
+   /// @return the fastest kernel that can be used on this machine, detected once at runtime
+   sha256_kernel sha256_best_kernel();
+
+   /**
+    *  @brief Compute the SHA-256 digests of many independent messages at once
+    *
+    *  Block validation and replay hash large numbers of small messages, e.g. the transactions of a block and the
+    *  nodes of its merkle tree. Hashing them together allows the use of kernels which process several messages in
+    *  parallel, and avoids the per-call setup cost of fc::sha256::encoder.
+    *
+    *  @param messages the messages to hash
+    *  @param count the number of messages
+    *  @param results receives the digests, must have room for @p count elements
+    *  @param kernel the implementation to use, must be supported
+    */
+   void sha256_batch( const sha256_message* messages, size_t count, fc::sha256* results,
+                      sha256_kernel kernel = sha256_best_kernel() );
+
+} } // graphene::protocol
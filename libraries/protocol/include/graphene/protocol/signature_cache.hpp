@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/protocol/types.hpp>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace graphene { namespace protocol {
+
+   /**
+    *  @brief A bounded cache of public keys recovered from compact signatures
+    *
+    *  The same signature is recovered several times during its lifetime: when the transaction is received, when
+    *  it is included in a block, on fork switches and when API clients verify it. Recovery only depends on the
+    *  signed digest and the signature, so all of them can share the result.
+    *
+    *  The cache is split into independently locked shards, so it can be filled by parallel precomputation while
+    *  the chain thread reads it. Each shard evicts its oldest entries first.
+    */
+   class signature_cache
+   {
+   public:
+      /// The process-wide cache used for transaction signatures
+      static signature_cache& instance();
+
+      explicit signature_cache( size_t capacity = default_capacity );
+
+      /**
+       * Recover the public key which produced the given signature of the given digest, consulting the cache first.
+       * @throws fc::exception if the signature is not canonical or no key can be recovered
+       */
+      public_key_type recover( const digest_type& digest, const signature_type& signature );
+
+      /// Set the maximum number of cached keys, 0 disables caching. Excess entries are evicted.
+      void   set_capacity( size_t capacity );
+      size_t capacity()const { return _capacity; }
+      size_t size()const;
+      void   clear();
+
+      uint64_t hits()const   { return _hits.load(); }
+      uint64_t misses()const { return _misses.load(); }
+
+      static const size_t default_capacity = 65536;
+
+   private:
+      struct cache_key
+      {
+         digest_type    digest;
+         signature_type signature;
+
+         bool operator == ( const cache_key& other )const
+         {
+            return digest == other.digest && signature == other.signature;
+         }
+      };
+
+      struct cache_key_hash
+      {
+         size_t operator()( const cache_key& key )const;
+      };
+
+      struct shard
+      {
+         mutable std::mutex                                             mutex;
+         std::unordered_map<cache_key, public_key_type, cache_key_hash> keys;
+         std::deque<cache_key>                                          insertion_order;
+      };
+
+      static const size_t shard_count = 16;
+
+      shard&   shard_for( const cache_key& key );
+      size_t   shard_capacity()const { return ( _capacity + shard_count - 1 ) / shard_count; }
+      void     evict( shard& s, size_t max_size );
+
+      std::atomic<size_t>             _capacity;
+      std::atomic<uint64_t>           _hits{0};
+      std::atomic<uint64_t>           _misses{0};
+      std::array<shard, shard_count>  _shards;
+   };
+
+} } // graphene::protocol
@@ -24,8 +24,12 @@
 #pragma once
 #include <graphene/protocol/operations.hpp>
 
+#include <functional>
+
 namespace graphene { namespace protocol {
 
+   class authority_cache;
+
    /**
     * @defgroup transactions Transactions
     *
@@ -87,6 +91,8 @@ namespace graphene { namespace protocol {
       digest_type                        digest()const;
       virtual const transaction_id_type& id()const;
       virtual void                       validate() const;
+      /// Checks that there is an operation, and calls validate_operation for each one, see validate()
+      void validate_operations( const std::function<void( const operation& )>& validate_operation )const;
 
       void set_expiration( fc::time_point_sec expiration_time );
       void set_reference_block( const block_id_type& reference_block );
@@ -164,13 +170,16 @@ namespace graphene { namespace protocol {
        *            required accounts to authorize operations in the transaction
        * @param max_recursion maximum level of recursion when verifying, since an account
        *            can have another account in active authorities and/or owner authorities
+       * @param cache optional cache of authorization outcomes of the accounts which get_active and get_owner
+       *            belong to
        */
       void verify_authority(
          const chain_id_type& chain_id,
          const std::function<const authority*(account_id_type)>& get_active,
          const std::function<const authority*(account_id_type)>& get_owner,
          bool allow_non_immediate_owner,
-         uint32_t max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH )const;
+         uint32_t max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH,
+         authority_cache* cache = nullptr )const;
 
       /**
        * This is a slower replacement for get_required_signatures()
@@ -209,6 +218,9 @@ namespace graphene { namespace protocol {
       /** Removes all signatures */
       void clear_signatures() { signatures.clear(); }
    protected:
+      /** Recover the public keys from the signatures of the given signature digest and store them in @ref _signees */
+      const flat_set<public_key_type>& recover_signature_keys( const digest_type& sig_digest )const;
+
       /** Public keys extracted from signatures */
       mutable flat_set<public_key_type> _signees;
    };
@@ -226,9 +238,21 @@ namespace graphene { namespace protocol {
 
       virtual const transaction_id_type&       id()const override;
       virtual void                             validate()const override;
+      /// Like validate(), but calls validate_operation instead of operation_validate for each operation
+      void validate( const std::function<void( const operation& )>& validate_operation )const;
       virtual const flat_set<public_key_type>& get_signature_keys( const chain_id_type& chain_id )const override;
       virtual uint64_t                         get_packed_size()const override;
+
+      /// Compute and cache the ids and packed sizes of several transactions at once, see @ref sha256_batch
+      static void precompute_ids( const precomputable_transaction* const* trxs, size_t count );
    protected:
+      /**
+       * Pack the transaction once to cache its id and packed size and to compute the digest to be signed
+       * @return the signature digest, see transaction::sig_digest()
+       */
+      digest_type compute_digests( const chain_id_type& chain_id )const;
+      void set_id( const digest_type& digest )const;
+
       mutable bool _validated = false;
       mutable uint64_t _packed_size = 0;
    };
@@ -248,6 +272,7 @@ namespace graphene { namespace protocol {
     * @param allow_committee whether to allow the special "committee account" to authorize the operations
     * @param active_approvals accounts that approved the operations with their active authories
     * @param owner_approvals accounts that approved the operations with their owner authories
+    * @param cache optional cache of authorization outcomes of the accounts which get_active and get_owner belong to
     */
    void verify_authority( const vector<operation>& ops, const flat_set<public_key_type>& sigs,
                           const std::function<const authority*(account_id_type)>& get_active,
@@ -256,7 +281,8 @@ namespace graphene { namespace protocol {
                           uint32_t max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH,
                           bool allow_committe = false,
                           const flat_set<account_id_type>& active_aprovals = flat_set<account_id_type>(),
-                          const flat_set<account_id_type>& owner_approvals = flat_set<account_id_type>());
+                          const flat_set<account_id_type>& owner_approvals = flat_set<account_id_type>(),
+                          authority_cache* cache = nullptr );
 
    /**
     *  @brief captures the result of evaluating the operations contained in the transaction
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <fc/static_variant.hpp>
+
+#include <type_traits>
+
+namespace graphene { namespace protocol {
+
+   /**
+    *  @brief Visits a static_variant through a flat table of function pointers
+    *
+    *  For every pair of variant and visitor types, a table with one entry per alternative is generated at compile
+    *  time, so a visit costs one indexed indirect call regardless of the position of the alternative in the
+    *  variant. All call sites using the same visitor type share the table.
+    *
+    *  The visitor must define result_type, as for static_variant::visit().
+    */
+   template<typename Variant>
+   struct variant_dispatcher;
+
+   template<typename... Types>
+   struct variant_dispatcher< fc::static_variant<Types...> >
+   {
+      typedef fc::static_variant<Types...> variant_type;
+
+      template<typename Visitor>
+      static typename Visitor::result_type visit( const variant_type& var, Visitor& visitor )
+      {
+         typedef typename Visitor::result_type (*handler)( const variant_type&, Visitor& );
+         static constexpr handler table[] = { &invoke_const<Types, Visitor>... };
+         return table[ var.which() ]( var, visitor );
+      }
+
+      template<typename Visitor>
+      static typename Visitor::result_type visit( variant_type& var, Visitor& visitor )
+      {
+         typedef typename Visitor::result_type (*handler)( variant_type&, Visitor& );
+         static constexpr handler table[] = { &invoke<Types, Visitor>... };
+         return table[ var.which() ]( var, visitor );
+      }
+
+   private:
+      template<typename T, typename Visitor>
+      static typename Visitor::result_type invoke_const( const variant_type& var, Visitor& visitor )
+      {
+         return visitor( var.template get<T>() );
+      }
+
+      template<typename T, typename Visitor>
+      static typename Visitor::result_type invoke( variant_type& var, Visitor& visitor )
+      {
+         return visitor( var.template get<T>() );
+      }
+   };
+
+   /// Visit @p var with @p visitor through the dispatch table of the visitor type, see @ref variant_dispatcher
+   template<typename Variant, typename Visitor>
+   typename std::decay<Visitor>::type::result_type dispatch( Variant& var, Visitor&& visitor )
+   {
+      return variant_dispatcher< typename std::remove_const<Variant>::type >::visit( var, visitor );
+   }
+
+} } // graphene::protocol
@@ -23,6 +23,7 @@
  */
 #include <graphene/protocol/operations.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
+#include <graphene/protocol/variant_dispatch.hpp>
 
 #include <fc/io/raw.hpp>
 
@@ -82,7 +83,7 @@ struct operation_get_required_auth
 
 void operation_validate( const operation& op )
 {
-   op.visit( operation_validator() );
+   dispatch( op, operation_validator() );
 }
 
 void operation_get_required_authorities( const operation& op, 
@@ -90,7 +91,7 @@ void operation_get_required_authorities( const operation& op,
                                          flat_set<account_id_type>& owner,
                                          vector<authority>&  other )
 {
-   op.visit( operation_get_required_auth( active, owner, other ) );
+   dispatch( op, operation_get_required_auth( active, owner, other ) );
 }
 
 } } // namespace graphene::protocol
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/protocol/sha256_batch.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && ( defined(__GNUC__) || defined(__clang__) )
+#define GRAPHENE_SHA256_X86_KERNELS
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace graphene { namespace protocol {
+
+namespace {
+
+const uint32_t sha256_k[64] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t sha256_iv[8] = {
+   0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ *  The blocks of a message after padding: the complete blocks are read in place, the last one or two blocks,
+ *  which contain the remaining bytes, the padding and the length, are built in a local buffer.
+ */
+struct padded_message
+{
+   const char* data = nullptr;
+   size_t      full_blocks = 0;
+   size_t      total_blocks = 0;
+   char        tail[128];
+
+   void reset( const sha256_message& m )
+   {
+      data = m.data;
+      full_blocks = m.size / 64;
+      const size_t rest = m.size % 64;
+      const size_t tail_blocks = rest + 9 <= 64 ? 1 : 2;
+      total_blocks = full_blocks + tail_blocks;
+
+      memset( tail, 0, sizeof(tail) );
+      if( rest > 0 )
+         memcpy( tail, m.data + full_blocks * 64, rest );
+      tail[rest] = char(0x80);
+      const uint64_t bits = uint64_t(m.size) * 8;
+      char* length = tail + tail_blocks * 64 - 8;
+      for( int i = 0; i < 8; ++i )
+         length[i] = char( bits >> ( 56 - 8 * i ) );
+   }
+
+   const char* block( size_t i )const
+   {
+      return i < full_blocks ? data + i * 64 : tail + ( i - full_blocks ) * 64;
+   }
+};
+
+void store_digest( const uint32_t state[8], fc::sha256& result )
+{
+   unsigned char* out = reinterpret_cast<unsigned char*>( result._hash );
+   for( int i = 0; i < 8; ++i )
+   {
+      out[4*i]   = (unsigned char)( state[i] >> 24 );
+      out[4*i+1] = (unsigned char)( state[i] >> 16 );
+      out[4*i+2] = (unsigned char)( state[i] >> 8 );
+      out[4*i+3] = (unsigned char)( state[i] );
+   }
+}
+
+void hash_scalar( const sha256_message* messages, size_t count, fc::sha256* results )
+{
+   for( size_t i = 0; i < count; ++i )
+      results[i] = fc::sha256::hash( messages[i].data, messages[i].size );
+}
+
+#ifdef GRAPHENE_SHA256_X86_KERNELS
+
+bool cpu_has_sha_ni()
+{
+   unsigned int eax, ebx, ecx, edx;
+   if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+      return false;
+   const bool has_ssse3 = ( ecx & bit_SSSE3 ) != 0;
+   const bool has_sse41 = ( ecx & bit_SSE4_1 ) != 0;
+   if( !__get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) )
+      return false;
+   return has_ssse3 && has_sse41 && ( ebx & ( 1u << 29 ) ) != 0;
+}
+
+bool cpu_has_avx2()
+{
+   // also checks that the operating system saves the AVX registers
+   __builtin_cpu_init();
+   return __builtin_cpu_supports( "avx2" );
+}
+
+/// Process @p count consecutive blocks with the SHA extensions
+__attribute__((target("sha,sse4.1,ssse3")))
+void sha_ni_compress( uint32_t state[8], const char* blocks, size_t count )
+{
+   const __m128i byte_swap = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL );
+
+   // the instructions expect the state as ABEF and CDGH
+   __m128i tmp    = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[0] ) );
+   __m128i state1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[4] ) );
+   tmp    = _mm_shuffle_epi32( tmp, 0xB1 );
+   state1 = _mm_shuffle_epi32( state1, 0x1B );
+   __m128i state0 = _mm_alignr_epi8( tmp, state1, 8 );
+   state1 = _mm_blend_epi16( state1, tmp, 0xF0 );
+
+   for( size_t b = 0; b < count; ++b, blocks += 64 )
+   {
+      const __m128i abef_save = state0;
+      const __m128i cdgh_save = state1;
+      __m128i w[4];
+
+      for( int i = 0; i < 16; ++i )
+      {
+         __m128i& current = w[i & 3];
+         if( i < 4 )
+            current = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( blocks + 16 * i ) ),
+                                        byte_swap );
+         else
+         {
+            // w[i-4] is the slot being overwritten
+            __m128i x = _mm_sha256msg1_epu32( current, w[(i - 3) & 3] );
+            x = _mm_add_epi32( x, _mm_alignr_epi8( w[(i - 1) & 3], w[(i - 2) & 3], 4 ) );
+            current = _mm_sha256msg2_epu32( x, w[(i - 1) & 3] );
+         }
+         __m128i msg = _mm_add_epi32( current,
+                                      _mm_loadu_si128( reinterpret_cast<const __m128i*>( &sha256_k[4 * i] ) ) );
+         state1 = _mm_sha256rnds2_epu32( state1, state0, msg );
+         msg    = _mm_shuffle_epi32( msg, 0x0E );
+         state0 = _mm_sha256rnds2_epu32( state0, state1, msg );
+      }
+
+      state0 = _mm_add_epi32( state0, abef_save );
+      state1 = _mm_add_epi32( state1, cdgh_save );
+   }
+
+   tmp    = _mm_shuffle_epi32( state0, 0x1B );
+   state1 = _mm_shuffle_epi32( state1, 0xB1 );
+   state0 = _mm_blend_epi16( tmp, state1, 0xF0 );
+   state1 = _mm_alignr_epi8( state1, tmp, 8 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[0] ), state0 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[4] ), state1 );
+}
+
+void hash_sha_ni( const sha256_message* messages, size_t count, fc::sha256* results )
+{
+   padded_message m;
+   for( size_t i = 0; i < count; ++i )
+   {
+      m.reset( messages[i] );
+      uint32_t state[8];
+      memcpy( state, sha256_iv, sizeof(state) );
+      if( m.full_blocks > 0 )
+         sha_ni_compress( state, m.data, m.full_blocks );
+      sha_ni_compress( state, m.tail, m.total_blocks - m.full_blocks );
+      store_digest( state, results[i] );
+   }
+}
+
+#define SHA256_ROTR( x, n ) _mm256_or_si256( _mm256_srli_epi32( (x), (n) ), _mm256_slli_epi32( (x), 32 - (n) ) )
+
+/// Process one block of each of eight messages, the state is stored word-major: state[word][lane]
+__attribute__((target("avx2")))
+void avx2_compress( uint32_t state[8][8], const char* const blocks[8] )
+{
+   __m256i w[64];
+   for( int t = 0; t < 16; ++t )
+   {
+      uint32_t words[8];
+      for( int lane = 0; lane < 8; ++lane )
+      {
+         uint32_t v;
+         memcpy( &v, blocks[lane] + 4 * t, sizeof(v) );
+         words[lane] = __builtin_bswap32( v );
+      }
+      w[t] = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( words ) );
+   }
+   for( int t = 16; t < 64; ++t )
+   {
+      const __m256i s0 = _mm256_xor_si256( _mm256_xor_si256( SHA256_ROTR( w[t-15], 7 ), SHA256_ROTR( w[t-15], 18 ) ),
+                                           _mm256_srli_epi32( w[t-15], 3 ) );
+      const __m256i s1 = _mm256_xor_si256( _mm256_xor_si256( SHA256_ROTR( w[t-2], 17 ), SHA256_ROTR( w[t-2], 19 ) ),
+                                           _mm256_srli_epi32( w[t-2], 10 ) );
+      w[t] = _mm256_add_epi32( _mm256_add_epi32( w[t-16], s0 ), _mm256_add_epi32( w[t-7], s1 ) );
+   }
+
+   __m256i v[8];
+   for( int i = 0; i < 8; ++i )
+      v[i] = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( state[i] ) );
+   __m256i a = v[0], b = v[1], c = v[2], d = v[3], e = v[4], f = v[5], g = v[6], h = v[7];
+
+   for( int t = 0; t < 64; ++t )
+   {
+      const __m256i s1  = _mm256_xor_si256( _mm256_xor_si256( SHA256_ROTR( e, 6 ), SHA256_ROTR( e, 11 ) ),
+                                            SHA256_ROTR( e, 25 ) );
+      const __m256i ch  = _mm256_xor_si256( _mm256_and_si256( e, f ), _mm256_andnot_si256( e, g ) );
+      const __m256i t1  = _mm256_add_epi32( _mm256_add_epi32( h, s1 ),
+                                            _mm256_add_epi32( _mm256_add_epi32( ch, w[t] ),
+                                                              _mm256_set1_epi32( int( sha256_k[t] ) ) ) );
+      const __m256i s0  = _mm256_xor_si256( _mm256_xor_si256( SHA256_ROTR( a, 2 ), SHA256_ROTR( a, 13 ) ),
+                                            SHA256_ROTR( a, 22 ) );
+      const __m256i maj = _mm256_or_si256( _mm256_and_si256( a, b ), _mm256_and_si256( c, _mm256_or_si256( a, b ) ) );
+      h = g;
+      g = f;
+      f = e;
+      e = _mm256_add_epi32( d, t1 );
+      d = c;
+      c = b;
+      b = a;
+      a = _mm256_add_epi32( t1, _mm256_add_epi32( s0, maj ) );
+   }
+
+   v[0] = _mm256_add_epi32( v[0], a ); v[1] = _mm256_add_epi32( v[1], b );
+   v[2] = _mm256_add_epi32( v[2], c ); v[3] = _mm256_add_epi32( v[3], d );
+   v[4] = _mm256_add_epi32( v[4], e ); v[5] = _mm256_add_epi32( v[5], f );
+   v[6] = _mm256_add_epi32( v[6], g ); v[7] = _mm256_add_epi32( v[7], h );
+   for( int i = 0; i < 8; ++i )
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>( state[i] ), v[i] );
+}
+
+#undef SHA256_ROTR
+
+/**
+ *  Hash the messages in eight lanes. A lane which finishes its message takes the next one, lanes which have run
+ *  out of messages hash a dummy block until all lanes are done.
+ */
+void hash_avx2( const sha256_message* messages, size_t count, fc::sha256* results )
+{
+   const size_t lanes = 8;
+   static const char idle_block[64] = {};
+
+   padded_message lane_message[lanes];
+   size_t         lane_index[lanes];   // index of the message in the lane, count if the lane is idle
+   size_t         lane_block[lanes];   // next block of the message in the lane
+   uint32_t       state[8][8];
+   const char*    blocks[lanes];
+
+   size_t next = 0;
+   size_t busy = 0;
+   auto load_lane = [&]( size_t lane ) {
+      lane_index[lane] = next;
+      lane_block[lane] = 0;
+      for( int i = 0; i < 8; ++i )
+         state[i][lane] = sha256_iv[i];
+      if( next < count )
+      {
+         lane_message[lane].reset( messages[next] );
+         ++next;
+         ++busy;
+      }
+   };
+   for( size_t lane = 0; lane < lanes; ++lane )
+      load_lane( lane );
+
+   while( busy > 0 )
+   {
+      for( size_t lane = 0; lane < lanes; ++lane )
+         blocks[lane] = lane_index[lane] < count ? lane_message[lane].block( lane_block[lane] ) : idle_block;
+
+      avx2_compress( state, blocks );
+
+      for( size_t lane = 0; lane < lanes; ++lane )
+      {
+         if( lane_index[lane] >= count || ++lane_block[lane] < lane_message[lane].total_blocks )
+            continue;
+         uint32_t digest[8];
+         for( int i = 0; i < 8; ++i )
+            digest[i] = state[i][lane];
+         store_digest( digest, results[lane_index[lane]] );
+         --busy;
+         load_lane( lane );
+      }
+   }
+}
+
+#endif // GRAPHENE_SHA256_X86_KERNELS
+
+} // anonymous namespace
+
+bool sha256_kernel_supported( sha256_kernel kernel )
+{
+   switch( kernel )
+   {
+      case sha256_kernel::scalar:
+         return true;
+#ifdef GRAPHENE_SHA256_X86_KERNELS
+      case sha256_kernel::avx2:
+      {
+         static const bool supported = cpu_has_avx2();
+         return supported;
+      }
+      case sha256_kernel::sha_ni:
+      {
+         static const bool supported = cpu_has_sha_ni();
+         return supported;
+      }
+#endif
+      default:
+         return false;
+   }
+}
+
+sha256_kernel sha256_best_kernel()
+{
+   static const sha256_kernel best = sha256_kernel_supported( sha256_kernel::sha_ni ) ? sha256_kernel::sha_ni
+                                   : sha256_kernel_supported( sha256_kernel::avx2 )   ? sha256_kernel::avx2
+                                                                                      : sha256_kernel::scalar;
+   return best;
+}
+
+void sha256_batch( const sha256_message* messages, size_t count, fc::sha256* results, sha256_kernel kernel )
+{
+   FC_ASSERT( sha256_kernel_supported( kernel ), "SHA-256 kernel not supported on this machine" );
+   switch( kernel )
+   {
+#ifdef GRAPHENE_SHA256_X86_KERNELS
+      case sha256_kernel::sha_ni:
+         hash_sha_ni( messages, count, results );
+         return;
+      case sha256_kernel::avx2:
+         // filling a few of the eight lanes is slower than hashing the messages one by one
+         if( count >= 4 )
+         {
+            hash_avx2( messages, count, results );
+            return;
+         }
+         break;
+#endif
+      default:
+         break;
+   }
+   hash_scalar( messages, count, results );
+}
+
+} } // graphene::protocol
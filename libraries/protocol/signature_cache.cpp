@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/protocol/signature_cache.hpp>
+
+#include <cstring>
+
+namespace graphene { namespace protocol {
+
+const size_t signature_cache::default_capacity;
+const size_t signature_cache::shard_count;
+
+signature_cache& signature_cache::instance()
+{
+   static signature_cache cache;
+   return cache;
+}
+
+signature_cache::signature_cache( size_t capacity )
+   : _capacity( capacity )
+{}
+
+size_t signature_cache::cache_key_hash::operator()( const cache_key& key )const
+{
+   // both the digest and the "r" part of the signature are uniformly distributed
+   uint64_t d;
+   uint64_t r;
+   memcpy( &d, key.digest.data(), sizeof(d) );
+   memcpy( &r, key.signature.begin() + 1, sizeof(r) );
+   return static_cast<size_t>( d ^ ( r * 0x9e3779b97f4a7c15ULL ) );
+}
+
+signature_cache::shard& signature_cache::shard_for( const cache_key& key )
+{
+   return _shards[ cache_key_hash()( key ) % shard_count ];
+}
+
+void signature_cache::evict( shard& s, size_t max_size )
+{
+   while( s.keys.size() > max_size )
+   {
+      s.keys.erase( s.insertion_order.front() );
+      s.insertion_order.pop_front();
+   }
+}
+
+public_key_type signature_cache::recover( const digest_type& digest, const signature_type& signature )
+{
+   const cache_key key{ digest, signature };
+   shard& s = shard_for( key );
+   {
+      std::lock_guard<std::mutex> guard( s.mutex );
+      auto itr = s.keys.find( key );
+      if( itr != s.keys.end() )
+      {
+         ++_hits;
+         return itr->second;
+      }
+   }
+   ++_misses;
+
+   // recover outside of the lock, this is the expensive part
+   public_key_type result( fc::ecc::public_key( signature, digest ) );
+
+   const size_t max_size = shard_capacity();
+   if( max_size > 0 )
+   {
+      std::lock_guard<std::mutex> guard( s.mutex );
+      if( s.keys.emplace( key, result ).second )
+      {
+         s.insertion_order.push_back( key );
+         evict( s, max_size );
+      }
+   }
+   return result;
+}
+
+void signature_cache::set_capacity( size_t capacity )
+{
+   _capacity = capacity;
+   const size_t max_size = shard_capacity();
+   for( shard& s : _shards )
+   {
+      std::lock_guard<std::mutex> guard( s.mutex );
+      evict( s, max_size );
+   }
+}
+
+size_t signature_cache::size()const
+{
+   size_t result = 0;
+   for( const shard& s : _shards )
+   {
+      std::lock_guard<std::mutex> guard( s.mutex );
+      result += s.keys.size();
+   }
+   return result;
+}
+
+void signature_cache::clear()
+{
+   for( shard& s : _shards )
+   {
+      std::lock_guard<std::mutex> guard( s.mutex );
+      s.keys.clear();
+      s.insertion_order.clear();
+   }
+   _hits = 0;
+   _misses = 0;
+}
+
+} } // graphene::protocol
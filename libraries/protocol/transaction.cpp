@@ -23,10 +23,14 @@
  */
 
 #include <graphene/protocol/transaction.hpp>
+#include <graphene/protocol/authority_cache.hpp>
 #include <graphene/protocol/block.hpp>
 #include <graphene/protocol/exceptions.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
+#include <graphene/protocol/pack_stream.hpp>
 #include <graphene/protocol/pts_address.hpp>
+#include <graphene/protocol/sha256_batch.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 
 #include <fc/io/raw.hpp>
 
@@ -55,10 +59,15 @@ digest_type transaction::sig_digest( const chain_id_type& chain_id )const
 }
 
 void transaction::validate() const
+{
+   validate_operations( operation_validate );
+}
+
+void transaction::validate_operations( const std::function<void( const operation& )>& validate_operation )const
 {
    FC_ASSERT( operations.size() > 0, "A transaction must have at least one operation", ("trx",*this) );
    for( const auto& op : operations )
-      operation_validate(op);
+      validate_operation( op );
 }
 
 uint64_t transaction::get_packed_size() const
@@ -124,10 +133,17 @@ struct sign_state
          {
             auto pk = available_keys.find(k);
             if( pk  != available_keys.end() )
-               return provided_signatures[k] = true;
+               return mark_used( k );
             return false;
          }
-         return itr->second = true;
+         return mark_used( k );
+      }
+
+      bool mark_used( const public_key_type& k )
+      {
+         if( used_keys != nullptr )
+            used_keys->insert( k );
+         return provided_signatures[k] = true;
       }
 
       optional<map<address,public_key_type>> available_address_sigs;
@@ -159,17 +175,84 @@ struct sign_state
             if( aitr != available_address_sigs->end() ) {
                auto pk = available_keys.find(aitr->second);
                if( pk != available_keys.end() )
-                  return provided_signatures[aitr->second] = true;
+                  return mark_used( aitr->second );
                return false;
             }
          }
-         return provided_signatures[itr->second] = true;
+         return mark_used( itr->second );
       }
 
       bool check_authority( account_id_type id )
       {
          if( approved_by.find(id) != approved_by.end() ) return true;
-         return check_authority( get_active(id) ) || ( allow_non_immediate_owner && check_authority( get_owner(id) ) );
+         if( cache != nullptr && nothing_approved() && available_keys.empty() )
+            return check_authority_cached( id );
+         return check_authority( active_of(id) ) || ( allow_non_immediate_owner && check_authority( owner_of(id) ) );
+      }
+
+      /**
+       *  The outcome of checking an account from a state in which no account has been approved only depends on the
+       *  provided keys and the authorities consulted, so it can be reused as long as those authorities don't change.
+       *  Replaying it marks the same signatures as used and approves the same accounts as the full check would.
+       *  The outcome keeps every key the check found signed, including keys which an earlier check of the same
+       *  transaction marked already, since the transaction reusing it may not require that earlier account.
+       */
+      bool check_authority_cached( account_id_type id )
+      {
+         const authority_cache::outcome* cached = cache->find( id, provided_keys, allow_non_immediate_owner,
+                                                               max_recursion );
+         if( cached != nullptr )
+         {
+            // let the caller observe the same lookups as if the authorities were walked
+            for( const auto& v : cached->authority_versions )
+               get_active( v.first );
+            for( const auto& k : cached->used_keys )
+               provided_signatures[k] = true;
+            approved_by.insert( cached->approved.begin(), cached->approved.end() );
+            return cached->satisfied;
+         }
+
+         flat_set<account_id_type> consulted;
+         flat_set<public_key_type> used;
+         consulted_accounts = &consulted;
+         used_keys = &used;
+         bool satisfied = false;
+         try {
+            satisfied = check_authority( active_of(id) )
+                        || ( allow_non_immediate_owner && check_authority( owner_of(id) ) );
+         } catch( ... ) {
+            consulted_accounts = nullptr;
+            used_keys = nullptr;
+            throw;
+         }
+         consulted_accounts = nullptr;
+         used_keys = nullptr;
+
+         flat_set<account_id_type> approved( approved_by );
+         approved.erase( GRAPHENE_TEMP_ACCOUNT );
+
+         cache->store( id, provided_keys, allow_non_immediate_owner, max_recursion,
+                       satisfied, std::move(used), std::move(approved), consulted );
+         return satisfied;
+      }
+
+      bool nothing_approved()const
+      {
+         return approved_by.size() == 1 && *approved_by.begin() == GRAPHENE_TEMP_ACCOUNT;
+      }
+
+      const authority* active_of( account_id_type id )
+      {
+         if( consulted_accounts != nullptr )
+            consulted_accounts->insert( id );
+         return get_active( id );
+      }
+
+      const authority* owner_of( account_id_type id )
+      {
+         if( consulted_accounts != nullptr )
+            consulted_accounts->insert( id );
+         return get_owner( id );
       }
 
       /**
@@ -204,8 +287,8 @@ struct sign_state
             {
                if( depth == max_recursion )
                   continue;
-               if( check_authority( get_active( a.first ), depth+1 )
-                     || ( allow_non_immediate_owner && check_authority( get_owner( a.first ), depth+1 ) ) )
+               if( check_authority( active_of( a.first ), depth+1 )
+                     || ( allow_non_immediate_owner && check_authority( owner_of( a.first ), depth+1 ) ) )
                {
                   approved_by.insert( a.first );
                   total_weight += a.second;
@@ -240,12 +323,15 @@ struct sign_state
                   const std::function<const authority*(account_id_type)>& owner,
                   bool allow_owner,
                   uint32_t max_recursion_depth = GRAPHENE_MAX_SIG_CHECK_DEPTH,
-                  const flat_set<public_key_type>& keys = empty_keyset )
+                  const flat_set<public_key_type>& keys = empty_keyset,
+                  authority_cache* outcome_cache = nullptr )
       :  get_active(active),
          get_owner(owner),
          allow_non_immediate_owner(allow_owner),
          max_recursion(max_recursion_depth),
-         available_keys(keys)
+         available_keys(keys),
+         provided_keys(sigs),
+         cache(outcome_cache)
       {
          for( const auto& key : sigs )
             provided_signatures[ key ] = false;
@@ -258,9 +344,15 @@ struct sign_state
       const bool                       allow_non_immediate_owner;
       const uint32_t                   max_recursion;
       const flat_set<public_key_type>& available_keys;
+      const flat_set<public_key_type>& provided_keys;
+      authority_cache* const           cache;
 
       flat_map<public_key_type,bool>   provided_signatures;
       flat_set<account_id_type>        approved_by;
+      /// accounts whose authorities are looked up, only recorded while an outcome for the cache is computed
+      flat_set<account_id_type>*       consulted_accounts = nullptr;
+      /// keys found signed, only recorded while an outcome for the cache is computed
+      flat_set<public_key_type>*       used_keys = nullptr;
 };
 
 
@@ -271,7 +363,8 @@ void verify_authority( const vector<operation>& ops, const flat_set<public_key_t
                        uint32_t max_recursion_depth,
                        bool  allow_committe,
                        const flat_set<account_id_type>& active_aprovals,
-                       const flat_set<account_id_type>& owner_approvals )
+                       const flat_set<account_id_type>& owner_approvals,
+                       authority_cache* cache )
 { try {
    flat_set<account_id_type> required_active;
    flat_set<account_id_type> required_owner;
@@ -284,7 +377,7 @@ void verify_authority( const vector<operation>& ops, const flat_set<public_key_t
       GRAPHENE_ASSERT( required_active.find(GRAPHENE_COMMITTEE_ACCOUNT) == required_active.end(),
                        invalid_committee_approval, "Committee account may only propose transactions" );
 
-   sign_state s( sigs, get_active, get_owner, allow_non_immediate_owner, max_recursion_depth );
+   sign_state s( sigs, get_active, get_owner, allow_non_immediate_owner, max_recursion_depth, empty_keyset, cache );
    for( auto& id : active_aprovals )
       s.approved_by.insert( id );
    for( auto& id : owner_approvals )
@@ -320,13 +413,18 @@ void verify_authority( const vector<operation>& ops, const flat_set<public_key_t
 
 
 const flat_set<public_key_type>& signed_transaction::get_signature_keys( const chain_id_type& chain_id )const
+{
+   return recover_signature_keys( sig_digest( chain_id ) );
+}
+
+const flat_set<public_key_type>& signed_transaction::recover_signature_keys( const digest_type& d )const
 { try {
-   auto d = sig_digest( chain_id );
    flat_set<public_key_type> result;
+   signature_cache& cache = signature_cache::instance();
    for( const auto&  sig : signatures )
    {
       GRAPHENE_ASSERT(
-         result.insert( fc::ecc::public_key(sig,d) ).second,
+         result.insert( cache.recover( d, sig ) ).second,
             tx_duplicate_sig,
             "Duplicate Signature detected" );
    }
@@ -406,6 +504,61 @@ const transaction_id_type& precomputable_transaction::id()const
    return _tx_id_buffer;
 }
 
+void precomputable_transaction::set_id( const digest_type& digest )const
+{
+   memcpy( _tx_id_buffer._hash, digest._hash, std::min( sizeof(_tx_id_buffer), sizeof(digest) ) );
+}
+
+void precomputable_transaction::precompute_ids( const precomputable_transaction* const* trxs, size_t count )
+{
+   vector<const precomputable_transaction*> missing;
+   missing.reserve( count );
+   for( size_t i = 0; i < count; ++i )
+      if( !trxs[i]->_tx_id_buffer._hash[0].value() )
+         missing.push_back( trxs[i] );
+   if( missing.empty() )
+      return;
+
+   // the id is derived from the digest of the unsigned transaction, see transaction::digest()
+   vector<char>& packed = thread_pack_buffer();
+   vector_stream stream( packed );
+   vector<size_t> ends( missing.size() );
+   for( size_t i = 0; i < missing.size(); ++i )
+   {
+      fc::raw::pack( stream, static_cast<const transaction&>( *missing[i] ) );
+      ends[i] = packed.size();
+   }
+
+   vector<sha256_message> messages( missing.size() );
+   for( size_t i = 0, start = 0; i < missing.size(); start = ends[i++] )
+   {
+      messages[i] = { packed.data() + start, ends[i] - start };
+      // the packed size is a by-product, see transaction::get_packed_size()
+      missing[i]->_packed_size = ends[i] - start;
+   }
+
+   vector<digest_type> digests( missing.size() );
+   sha256_batch( messages.data(), messages.size(), digests.data() );
+   for( size_t i = 0; i < missing.size(); ++i )
+      missing[i]->set_id( digests[i] );
+}
+
+digest_type precomputable_transaction::compute_digests( const chain_id_type& chain_id )const
+{
+   // the id, the signature digest and the packed size are all derived from the packed unsigned transaction,
+   // see transaction::digest(), transaction::sig_digest() and transaction::get_packed_size()
+   digest_type::encoder id_enc;
+   digest_type::encoder sig_enc;
+   fc::raw::pack( sig_enc, chain_id );
+   const bool need_id = !_tx_id_buffer._hash[0].value();
+   digest_stream<digest_type::encoder, 2> stream( {{ need_id ? &id_enc : nullptr, &sig_enc }} );
+   fc::raw::pack( stream, static_cast<const transaction&>( *this ) );
+   if( need_id )
+      set_id( id_enc.result() );
+   _packed_size = stream.size();
+   return sig_enc.result();
+}
+
 void precomputable_transaction::validate() const
 {
    if( _validated ) return;
@@ -413,6 +566,13 @@ void precomputable_transaction::validate() const
    _validated = true;
 }
 
+void precomputable_transaction::validate( const std::function<void( const operation& )>& validate_operation )const
+{
+   if( _validated ) return;
+   validate_operations( validate_operation );
+   _validated = true;
+}
+
 uint64_t precomputable_transaction::get_packed_size()const
 {
    if( _packed_size == 0 )
@@ -425,7 +585,7 @@ const flat_set<public_key_type>& precomputable_transaction::get_signature_keys(
    // Strictly we should check whether the given chain ID is same as the one used to initialize the `signees` field.
    // However, we don't pass in another chain ID so far, for better performance, we skip the check.
    if( _signees.empty() )
-      signed_transaction::get_signature_keys( chain_id );
+      recover_signature_keys( compute_digests( chain_id ) );
    return _signees;
 }
 
@@ -434,10 +594,12 @@ void signed_transaction::verify_authority(
    const std::function<const authority*(account_id_type)>& get_active,
    const std::function<const authority*(account_id_type)>& get_owner,
    bool allow_non_immediate_owner,
-   uint32_t max_recursion )const
+   uint32_t max_recursion,
+   authority_cache* cache )const
 { try {
    graphene::protocol::verify_authority( operations, get_signature_keys( chain_id ), get_active, get_owner,
-                                         allow_non_immediate_owner, max_recursion );
+                                         allow_non_immediate_owner, max_recursion, false,
+                                         flat_set<account_id_type>(), flat_set<account_id_type>(), cache );
 } FC_CAPTURE_AND_RETHROW( (*this) ) }
 
 } } // graphene::protocol
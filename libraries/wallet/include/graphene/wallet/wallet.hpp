@@ -180,9 +180,12 @@ struct wallet_data
       }
    }
 
-   /** encrypted keys */
+   /** encrypted keys, only read from wallets saved before the keys were sharded */
    vector<char>              cipher_keys;
 
+   /** encrypted keys split by public key, so that adding a key re-encrypts a single shard */
+   vector< vector<char> >    cipher_key_shards;
+
    /** map an account to a set of extra keys that have been imported for that account */
    map<account_id_type, set<public_key_type> >  extra_keys;
 
@@ -222,6 +225,15 @@ struct approval_delta
    vector<string> key_approvals_to_remove;
 };
 
+/// The outcome of one transaction of sign_transactions
+struct batch_transaction_result
+{
+   transaction_id_type  id;
+   bool                 broadcast = false;
+   /// why the transaction could not be signed or was rejected by the node
+   optional<string>     error;
+};
+
 struct worker_vote_delta
 {
    flat_set<worker_id_type> vote_for;
@@ -526,6 +538,15 @@ class wallet_api
        */
       variant                           get_object(object_id_type id) const;
 
+      /** Returns statistics of the cache of blockchain objects fetched by this wallet, for the tests.
+       *
+       * Not exported to the command line and the RPC interface.
+       *
+       * @returns the number of lookups served from the cache (\c hits) and from the node (\c misses),
+       *          and the number of accounts, assets and other objects cached now (\c objects)
+       */
+      variant_object                    get_cache_statistics() const;
+
       /** Returns the current wallet filename.  
        *
        * This is the filename that will be used when automatically saving the wallet.
@@ -1619,6 +1640,19 @@ class wallet_api
        */
       signed_transaction sign_transaction(signed_transaction tx, bool broadcast = false);
 
+      /** Signs and broadcasts many transactions.
+       *
+       * Like sign_transaction, for large numbers of transactions. The keys required by transactions which only
+       * need active authorities that a single key of this wallet satisfies are determined without asking the
+       * node, the transactions are signed in parallel and broadcast with up to \c max_pending broadcasts in
+       * flight. A transaction which cannot be signed or is rejected does not stop the others.
+       * @param txs the unsigned transactions
+       * @param max_pending the number of broadcasts to wait for at once
+       * @return the id of each transaction and whether it has been broadcast, in the order of \c txs
+       */
+      vector<batch_transaction_result> sign_transactions( vector<signed_transaction> txs,
+                                                          uint32_t max_pending = 100 );
+
       /** Get transaction signers.
        *
        * Returns information about who signed the transaction, specifically,
@@ -1762,6 +1796,7 @@ FC_REFLECT( graphene::wallet::wallet_data,
             (chain_id)
             (my_accounts)
             (cipher_keys)
+            (cipher_key_shards)
             (extra_keys)
             (pending_account_registrations)(pending_witness_registrations)
             (labeled_keys)
@@ -1793,6 +1828,8 @@ FC_REFLECT( graphene::wallet::approval_delta,
    (key_approvals_to_remove)
 )
 
+FC_REFLECT( graphene::wallet::batch_transaction_result, (id)(broadcast)(error) )
+
 FC_REFLECT( graphene::wallet::worker_vote_delta,
    (vote_for)
    (vote_against)
@@ -1913,6 +1950,7 @@ FC_API( graphene::wallet::wallet_api,
         (save_wallet_file)
         (serialize_transaction)
         (sign_transaction)
+        (sign_transactions)
         (add_transaction_signature)
         (get_transaction_signers)
         (get_key_references)
@@ -56,7 +56,9 @@
 #include <fc/rpc/cli.hpp>
 #include <fc/rpc/websocket_api.hpp>
 #include <fc/crypto/hex.hpp>
+#include <fc/asio.hpp>
 #include <fc/thread/mutex.hpp>
+#include <fc/thread/parallel.hpp>
 #include <fc/thread/scoped_lock.hpp>
 #include <fc/rpc/api_connection.hpp>
 #include <fc/crypto/base58.hpp>
@@ -344,7 +346,7 @@ private:
       FC_ASSERT(witness_private_key);
 
       auto pub_key = witness_private_key->get_public_key();
-      _keys[pub_key] = wif_key;
+      set_private_key( pub_key, wif_key );
       _wallet.pending_witness_registrations.erase(iter);
    }
 
@@ -460,6 +462,71 @@ private:
      > recently_generated_transaction_set_type;
    recently_generated_transaction_set_type _recently_generated_transactions;
 
+   /**
+    *  Objects fetched from the remote node, to save round trips when several commands or operations need them.
+    *  Everything is dropped when a new block is applied. Accounts, assets and objects fetched by id are also
+    *  dropped after this wallet broadcasts a transaction, since it may change them before the next block.
+    */
+   struct remote_object_cache
+   {
+      optional<global_property_object>          global_properties;
+      optional<dynamic_global_property_object>  dynamic_global_properties;
+      map<account_id_type, account_object>      accounts;
+      map<string, account_id_type>              account_ids_by_name;
+      map<asset_id_type, asset_object>          assets;
+      map<string, asset_id_type>                asset_ids_by_symbol;
+      /// other objects fetched by id, see get_objects
+      map<object_id_type, variant>              objects;
+      uint64_t                                  hits = 0;
+      uint64_t                                  misses = 0;
+
+      void add( const account_object& a )
+      {
+         accounts[a.id] = a;
+         account_ids_by_name[a.name] = a.id;
+      }
+      void add( const asset_object& a )
+      {
+         assets[a.id] = a;
+         asset_ids_by_symbol[a.symbol] = a.id;
+      }
+      const account_object* find_account( const string& name_or_id )const
+      {
+         auto name_itr = account_ids_by_name.find( name_or_id );
+         auto itr = ( name_itr != account_ids_by_name.end() ) ? accounts.find( name_itr->second )
+                                                                : accounts.end();
+         if( itr == accounts.end() )
+            if( auto id = maybe_id<account_id_type>( name_or_id ) )
+               itr = accounts.find( *id );
+         return itr != accounts.end() ? &itr->second : nullptr;
+      }
+      const asset_object* find_asset( const string& symbol_or_id )const
+      {
+         auto symbol_itr = asset_ids_by_symbol.find( symbol_or_id );
+         auto itr = ( symbol_itr != asset_ids_by_symbol.end() ) ? assets.find( symbol_itr->second )
+                                                                  : assets.end();
+         if( itr == assets.end() )
+            if( auto id = maybe_id<asset_id_type>( symbol_or_id ) )
+               itr = assets.find( *id );
+         return itr != assets.end() ? &itr->second : nullptr;
+      }
+      void forget_objects()
+      {
+         accounts.clear();
+         account_ids_by_name.clear();
+         assets.clear();
+         asset_ids_by_symbol.clear();
+         objects.clear();
+      }
+      void clear()
+      {
+         forget_objects();
+         global_properties.reset();
+         dynamic_global_properties.reset();
+      }
+   };
+   mutable remote_object_cache _cache;
+
 public:
    wallet_api& self;
    wallet_api_impl( wallet_api& s, const wallet_data& initial_data, fc::api<login_api> rapi )
@@ -505,20 +572,56 @@ public:
       }
    }
 
+   static const uint32_t key_shard_count = 16;
+
+   static uint32_t key_shard( const public_key_type& key )
+   {
+      // the first byte only holds the parity of y, the second one is uniformly distributed
+      return uint8_t( key.key_data.data[1] ) % key_shard_count;
+   }
+
+   /// store a private key, only its shard is encrypted again when the wallet is saved
+   void set_private_key( const public_key_type& key, const string& wif_key )
+   {
+      _keys[key] = wif_key;
+      _dirty_key_shards.insert( key_shard( key ) );
+   }
+
    void encrypt_keys()
    {
       if( !is_locked() )
       {
-         plain_keys data;
-         data.keys = _keys;
-         data.checksum = _checksum;
-         auto plain_txt = fc::raw::pack(data);
-         _wallet.cipher_keys = fc::aes_encrypt( data.checksum, plain_txt );
+         if( _wallet.cipher_key_shards.size() != key_shard_count )
+         {
+            // a new wallet, a wallet saved before sharding or a new password: encrypt every shard
+            _wallet.cipher_key_shards.resize( key_shard_count );
+            for( uint32_t shard = 0; shard < key_shard_count; ++shard )
+               _dirty_key_shards.insert( shard );
+         }
+         if( _dirty_key_shards.empty() )
+            return;
+
+         vector<plain_keys> data( key_shard_count );
+         for( const auto& key : _keys )
+         {
+            const uint32_t shard = key_shard( key.first );
+            if( _dirty_key_shards.count( shard ) )
+               data[shard].keys.emplace_hint( data[shard].keys.end(), key );
+         }
+         for( uint32_t shard : _dirty_key_shards )
+         {
+            data[shard].checksum = _checksum;
+            auto plain_txt = fc::raw::pack( data[shard] );
+            _wallet.cipher_key_shards[shard] = fc::aes_encrypt( _checksum, plain_txt );
+         }
+         _wallet.cipher_keys.clear();
+         _dirty_key_shards.clear();
       }
    }
 
    void on_block_applied( const variant& block_id )
    {
+      _cache.clear();
       fc::async([this]{resync();}, "Resync after block");
    }
 
@@ -560,13 +663,66 @@ public:
       return _checksum == fc::sha512();
    }
 
+   /// Look up objects by id, fetching those which are not cached yet with a single request
+   fc::variants get_objects( const vector<object_id_type>& ids )const
+   {
+      fc::variants result( ids.size() );
+      vector<object_id_type> missing;
+      for( size_t i = 0; i < ids.size(); ++i )
+      {
+         auto itr = _cache.objects.find( ids[i] );
+         if( itr != _cache.objects.end() )
+         {
+            ++_cache.hits;
+            result[i] = itr->second;
+         }
+         else
+         {
+            ++_cache.misses;
+            missing.push_back( ids[i] );
+         }
+      }
+      if( missing.empty() )
+         return result;
+
+      fc::variants fetched = _remote_db->get_objects( missing );
+      FC_ASSERT( fetched.size() == missing.size() );
+      auto fetched_itr = fetched.begin();
+      for( size_t i = 0; i < ids.size(); ++i )
+      {
+         // cached objects are never null, so the null entries are the missing ones in order
+         if( !result[i].is_null() )
+            continue;
+         result[i] = std::move( *fetched_itr++ );
+         // unknown objects are not cached, they may be created by the next block
+         if( !result[i].is_null() )
+            _cache.objects[ids[i]] = result[i];
+      }
+      return result;
+   }
+
+   variant_object get_cache_statistics()const
+   {
+      return fc::mutable_variant_object( "hits", _cache.hits )
+                                       ( "misses", _cache.misses )
+                                       ( "objects", _cache.accounts.size() + _cache.assets.size()
+                                                    + _cache.objects.size() );
+   }
+
    template<typename ID>
    graphene::db::object_downcast_t<ID> get_object(ID id)const
    {
-      auto ob = _remote_db->get_objects({id}).front();
+      auto ob = get_objects({id}).front();
       return ob.template as<graphene::db::object_downcast_t<ID>>( GRAPHENE_MAX_NESTED_OBJECTS );
    }
 
+   /// broadcast the transaction, and drop the cached objects it may change
+   void send_to_network( const signed_transaction& tx )
+   {
+      _remote_net_broadcast->broadcast_transaction( tx );
+      _cache.forget_objects();
+   }
+
    void set_operation_fees( signed_transaction& tx, const fee_schedule& s  )
    {
       for( auto& op : tx.operations )
@@ -638,11 +794,54 @@ public:
    }
    global_property_object get_global_properties() const
    {
-      return _remote_db->get_global_properties();
+      if( _cache.global_properties.valid() )
+         ++_cache.hits;
+      else
+      {
+         ++_cache.misses;
+         _cache.global_properties = _remote_db->get_global_properties();
+      }
+      return *_cache.global_properties;
    }
    dynamic_global_property_object get_dynamic_global_properties() const
    {
-      return _remote_db->get_dynamic_global_properties();
+      if( _cache.dynamic_global_properties.valid() )
+         ++_cache.hits;
+      else
+      {
+         ++_cache.misses;
+         _cache.dynamic_global_properties = _remote_db->get_dynamic_global_properties();
+      }
+      return *_cache.dynamic_global_properties;
+   }
+   /**
+    * Fetch the given accounts which are not cached yet with a single request. Unknown accounts are ignored here,
+    * looking them up reports the error.
+    */
+   void prefetch_accounts( const vector<string>& names_or_ids ) const
+   {
+      vector<string> missing;
+      for( const string& name_or_id : names_or_ids )
+         if( !name_or_id.empty() && _cache.find_account( name_or_id ) == nullptr )
+            missing.push_back( name_or_id );
+      if( missing.empty() )
+         return;
+      for( const optional<account_object>& rec : _remote_db->get_accounts( missing ) )
+         if( rec )
+            _cache.add( *rec );
+   }
+   /// Fetch the given assets which are not cached yet with a single request, see prefetch_accounts
+   void prefetch_assets( const vector<string>& symbols_or_ids ) const
+   {
+      vector<string> missing;
+      for( const string& symbol_or_id : symbols_or_ids )
+         if( !symbol_or_id.empty() && _cache.find_asset( symbol_or_id ) == nullptr )
+            missing.push_back( symbol_or_id );
+      if( missing.empty() )
+         return;
+      for( const optional<asset_object>& rec : _remote_db->get_assets( missing ) )
+         if( rec )
+            _cache.add( *rec );
    }
    std::string account_id_to_string(account_id_type id) const
    {
@@ -653,10 +852,19 @@ public:
    }
    account_object get_account(account_id_type id) const
    {
+      auto itr = _cache.accounts.find( id );
+      if( itr != _cache.accounts.end() )
+      {
+         ++_cache.hits;
+         return itr->second;
+      }
+      ++_cache.misses;
+
       std::string account_id = account_id_to_string(id);
 
       auto rec = _remote_db->get_accounts({account_id}).front();
       FC_ASSERT(rec);
+      _cache.add( *rec );
       return *rec;
    }
    account_object get_account(string account_name_or_id) const
@@ -668,8 +876,13 @@ public:
          // It's an ID
          return get_account(*id);
       } else {
+         auto name_itr = _cache.account_ids_by_name.find( account_name_or_id );
+         if( name_itr != _cache.account_ids_by_name.end() )
+            return get_account( name_itr->second );
+         ++_cache.misses;
          auto rec = _remote_db->lookup_account_names({account_name_or_id}).front();
          FC_ASSERT( rec && rec->name == account_name_or_id );
+         _cache.add( *rec );
          return *rec;
       }
    }
@@ -686,7 +899,17 @@ public:
    }
    optional<asset_object> find_asset(asset_id_type id)const
    {
+      auto itr = _cache.assets.find( id );
+      if( itr != _cache.assets.end() )
+      {
+         ++_cache.hits;
+         return itr->second;
+      }
+      ++_cache.misses;
+
       auto rec = _remote_db->get_assets({asset_id_to_string(id)}).front();
+      if( rec )
+         _cache.add( *rec );
       return rec;
    }
    optional<asset_object> find_asset(string asset_symbol_or_id)const
@@ -699,11 +922,16 @@ public:
          return find_asset(*id);
       } else {
          // It's a symbol
+         auto symbol_itr = _cache.asset_ids_by_symbol.find( asset_symbol_or_id );
+         if( symbol_itr != _cache.asset_ids_by_symbol.end() )
+            return find_asset( symbol_itr->second );
+         ++_cache.misses;
          auto rec = _remote_db->lookup_asset_symbols({asset_symbol_or_id}).front();
          if( rec )
          {
             if( rec->symbol != asset_symbol_or_id )
                return optional<asset_object>();
+            _cache.add( *rec );
          }
          return rec;
       }
@@ -725,7 +953,7 @@ public:
    {
       htlc_id_type id;
       fc::from_variant(htlc_id, id);
-      auto obj = _remote_db->get_objects( { id }).front();
+      auto obj = get_objects( { id } ).front();
       if ( !obj.is_null() )
       {
          return fc::optional<htlc_object>(obj.template as<htlc_object>(GRAPHENE_MAX_NESTED_OBJECTS));
@@ -739,8 +967,16 @@ public:
       vector<optional<asset_object>> opt_asset;
       if( std::isdigit( asset_symbol_or_id.front() ) )
          return fc::variant(asset_symbol_or_id, 1).as<asset_id_type>( 1 );
+      auto symbol_itr = _cache.asset_ids_by_symbol.find( asset_symbol_or_id );
+      if( symbol_itr != _cache.asset_ids_by_symbol.end() )
+      {
+         ++_cache.hits;
+         return symbol_itr->second;
+      }
+      ++_cache.misses;
       opt_asset = _remote_db->lookup_asset_symbols( {asset_symbol_or_id} );
       FC_ASSERT( (opt_asset.size() > 0) && (opt_asset[0].valid()) );
+      _cache.add( *opt_asset[0] );
       return opt_asset[0]->id;
    }
 
@@ -790,7 +1026,7 @@ public:
             std::inserter(all_keys_for_account, all_keys_for_account.end()));
       all_keys_for_account.insert(account.options.memo_key);
 
-      _keys[wif_pub_key] = wif_key;
+      set_private_key( wif_pub_key, wif_key );
 
       _wallet.update_account(account);
 
@@ -921,7 +1157,7 @@ public:
       {
          try
          {
-            _remote_net_broadcast->broadcast_transaction( tx );
+            send_to_network( tx );
          }
          catch ( const fc::exception &e )
          {
@@ -1035,7 +1271,7 @@ public:
       auto fee_asset_obj = get_asset(fee_asset);
       asset total_fee = fee_asset_obj.amount(0);
 
-      auto gprops = _remote_db->get_global_properties().parameters;
+      auto gprops = get_global_properties().parameters;
       if( fee_asset_obj.get_id() != asset_id_type() )
       {
          for( auto& op : _builder_transactions[handle].operations )
@@ -1068,7 +1304,7 @@ public:
    pair<transaction_id_type,signed_transaction> broadcast_transaction(signed_transaction tx)
    {
        try {
-           _remote_net_broadcast->broadcast_transaction(tx);
+           send_to_network( tx );
        }
        catch (const fc::exception& e) {
            elog("Caught exception while broadcasting tx ${id}:  ${e}",
@@ -1092,7 +1328,7 @@ public:
       if( review_period_seconds )
          op.review_period_seconds = review_period_seconds;
       trx.operations = {op};
-      _remote_db->get_global_properties().parameters.get_current_fees().set_fee( trx.operations.front() );
+      get_global_properties().parameters.get_current_fees().set_fee( trx.operations.front() );
 
       return trx = sign_transaction(trx, broadcast);
    }
@@ -1113,7 +1349,7 @@ public:
       if( review_period_seconds )
          op.review_period_seconds = review_period_seconds;
       trx.operations = {op};
-      _remote_db->get_global_properties().parameters.get_current_fees().set_fee( trx.operations.front() );
+      get_global_properties().parameters.get_current_fees().set_fee( trx.operations.front() );
 
       return trx = sign_transaction(trx, broadcast);
    }
@@ -1162,7 +1398,7 @@ public:
 
       tx.operations.push_back( account_create_op );
 
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees() );
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees() );
 
       vector<public_key_type> paying_keys = registrar_account_object.active.get_keys();
 
@@ -1186,7 +1422,7 @@ public:
       }
 
       if( broadcast )
-         _remote_net_broadcast->broadcast_transaction( tx );
+         send_to_network( tx );
       return tx;
    } FC_CAPTURE_AND_RETHROW( (name)(owner)(active)(registrar_account)
                              (referrer_account)(referrer_percent)(broadcast) ) }
@@ -1202,7 +1438,7 @@ public:
       op.account_to_upgrade = account_obj.get_id();
       op.upgrade_to_lifetime_member = true;
       tx.operations = {op};
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees() );
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees() );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1212,34 +1448,52 @@ public:
    // the index until it finds a key that isn't registered in the block chain.  To be
    // safer, it continues checking for a few more keys to make sure there wasn't a short gap
    // caused by a failed registration or the like.
+   // The keys are derived in parallel batches and checked in order.
    int find_first_unused_derived_key_index(const fc::ecc::private_key& parent_key)
    {
+      const string parent_wif = key_to_wif( parent_key );
+      const uint32_t threads = std::max<uint32_t>( 1u, fc::asio::default_io_service_scope::get_num_threads() );
+      const uint32_t keys_per_thread = 8;
+      vector<public_key_type> derived_public_keys( threads * keys_per_thread );
+
       int first_unused_index = 0;
       int number_of_consecutive_unused_keys = 0;
-      for (int key_index = 0; ; ++key_index)
+      for (int batch_start = 0; ; batch_start += derived_public_keys.size())
       {
-         fc::ecc::private_key derived_private_key = derive_private_key(key_to_wif(parent_key), key_index);
-         graphene::chain::public_key_type derived_public_key = derived_private_key.get_public_key();
-         if( _keys.find(derived_public_key) == _keys.end() )
+         vector< fc::future<void> > derivers;
+         derivers.reserve( threads );
+         for( uint32_t thread = 0; thread < threads; ++thread )
+            derivers.push_back( fc::do_parallel( [&parent_wif,&derived_public_keys,batch_start,thread,keys_per_thread] () {
+               for( uint32_t i = thread * keys_per_thread; i < (thread + 1) * keys_per_thread; ++i )
+                  derived_public_keys[i] = derive_private_key( parent_wif, batch_start + i ).get_public_key();
+            } ) );
+         for( auto& deriver : derivers )
+            deriver.wait();
+
+         for (size_t i = 0; i < derived_public_keys.size(); ++i)
          {
-            if (number_of_consecutive_unused_keys)
+            const int key_index = batch_start + i;
+            if( _keys.find(derived_public_keys[i]) == _keys.end() )
             {
-               ++number_of_consecutive_unused_keys;
-               if (number_of_consecutive_unused_keys > 5)
-                  return first_unused_index;
+               if (number_of_consecutive_unused_keys)
+               {
+                  ++number_of_consecutive_unused_keys;
+                  if (number_of_consecutive_unused_keys > 5)
+                     return first_unused_index;
+               }
+               else
+               {
+                  first_unused_index = key_index;
+                  number_of_consecutive_unused_keys = 1;
+               }
             }
             else
             {
-               first_unused_index = key_index;
-               number_of_consecutive_unused_keys = 1;
+               // key_index is used
+               first_unused_index = 0;
+               number_of_consecutive_unused_keys = 0;
             }
          }
-         else
-         {
-            // key_index is used
-            first_unused_index = 0;
-            number_of_consecutive_unused_keys = 0;
-         }
       }
    }
 
@@ -1287,7 +1541,7 @@ public:
 
          tx.operations.push_back( account_create_op );
 
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+         set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
 
          vector<public_key_type> paying_keys = registrar_account_object.active.get_keys();
 
@@ -1314,7 +1568,7 @@ public:
          if( save_wallet )
             save_wallet_file();
          if( broadcast )
-            _remote_net_broadcast->broadcast_transaction( tx );
+            send_to_network( tx );
          return tx;
    } FC_CAPTURE_AND_RETHROW( (account_name)(registrar_account)(referrer_account)(broadcast) ) }
 
@@ -1353,7 +1607,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1381,7 +1635,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1404,7 +1658,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_issuer );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1425,7 +1679,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1449,7 +1703,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1471,7 +1725,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( publish_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1495,7 +1749,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( fund_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1517,7 +1771,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( claim_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1540,7 +1794,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( reserve_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1561,7 +1815,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( settle_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1582,7 +1836,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( settle_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1608,7 +1862,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1626,7 +1880,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( whitelist_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1644,7 +1898,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( committee_member_create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1743,7 +1997,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( witness_create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       _wallet.pending_witness_registrations[owner_account] = key_to_wif(witness_private_key);
@@ -1769,7 +2023,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( witness_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees() );
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees() );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1820,7 +2074,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees() );
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees() );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1862,7 +2116,7 @@ public:
 
       flat_set<vote_id_type> new_votes( acct.options.votes );
 
-      fc::variants objects = _remote_db->get_objects( query_ids );
+      fc::variants objects = get_objects( query_ids );
       for( const variant& obj : objects )
       {
          worker_object wo;
@@ -1884,7 +2138,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees() );
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees() );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1923,7 +2177,7 @@ public:
 
          signed_transaction tx;
          tx.operations.push_back(create_op);
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+         set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
          tx.validate();
 
          return sign_transaction(tx, broadcast);
@@ -1948,7 +2202,7 @@ public:
 
          signed_transaction tx;
          tx.operations.push_back(update_op);
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+         set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
          tx.validate();
 
          return sign_transaction(tx, broadcast);
@@ -1972,7 +2226,7 @@ public:
 
          signed_transaction tx;
          tx.operations.push_back(update_op);
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+         set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
          tx.validate();
 
          return sign_transaction(tx, broadcast);
@@ -1983,7 +2237,7 @@ public:
    { try {
       fc::optional<vesting_balance_id_type> vbid = maybe_id<vesting_balance_id_type>( account_name );
       std::vector<vesting_balance_object_with_info> result;
-      fc::time_point_sec now = _remote_db->get_dynamic_global_properties().time;
+      fc::time_point_sec now = get_dynamic_global_properties().time;
 
       if( vbid )
       {
@@ -2026,7 +2280,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( vesting_balance_withdraw_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees() );
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees() );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2064,7 +2318,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2100,7 +2354,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2132,7 +2386,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2160,19 +2414,19 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
    } FC_CAPTURE_AND_RETHROW( (account_to_modify)(desired_number_of_witnesses)
                              (desired_number_of_committee_members)(broadcast) ) }
 
-   signed_transaction sign_transaction(signed_transaction tx, bool broadcast = false)
+   /**
+    * Set the reference block and an expiration which makes the transaction id differ from the ones generated
+    * recently, so the same operations can be sent several times within a block.
+    */
+   void set_unique_expiration( signed_transaction& tx, const dynamic_global_property_object& dyn_props )
    {
-
-      set<public_key_type> approving_key_set = get_owned_required_keys(tx);
-
-      auto dyn_props = get_dynamic_global_properties();
       tx.set_reference_block( dyn_props.head_block_id );
 
       // first, some bookkeeping, expire old items from _recently_generated_transactions
@@ -2185,15 +2439,13 @@ public:
       auto begin_iter = _recently_generated_transactions.get<timestamp_index>().begin();
       _recently_generated_transactions.get<timestamp_index>().erase(begin_iter, oldest_transaction_record_iter);
 
+      // the signatures are not part of the id, so the transaction is only signed once a unique id has been found
       uint32_t expiration_time_offset = 0;
       for (;;)
       {
          tx.set_expiration( dyn_props.time + fc::seconds(30 + expiration_time_offset) );
          tx.clear_signatures();
 
-         for( const public_key_type& key : approving_key_set )
-            tx.sign( get_private_key(key), _chain_id );
-
          graphene::chain::transaction_id_type this_transaction_id = tx.id();
          auto iter = _recently_generated_transactions.find(this_transaction_id);
          if (iter == _recently_generated_transactions.end())
@@ -2206,15 +2458,37 @@ public:
             break;
          }
 
-         // else we've generated a dupe, increment expiration time and re-sign it
+         // else we've generated a dupe, increment expiration time
          ++expiration_time_offset;
       }
+   }
+
+   signed_transaction sign_transaction(signed_transaction tx, bool broadcast = false)
+   {
+      flat_set<string> authority_accounts;
+      add_authority_accounts( tx, authority_accounts );
+      prefetch_accounts( vector<string>( authority_accounts.begin(), authority_accounts.end() ) );
+
+      flat_set<public_key_type> approving_key_set;
+      auto local_keys = get_local_required_keys( tx );
+      if( local_keys.valid() )
+         approving_key_set = std::move( *local_keys );
+      else
+      {
+         const auto remote_keys = get_owned_required_keys( tx );
+         approving_key_set.insert( remote_keys.begin(), remote_keys.end() );
+      }
+
+      set_unique_expiration( tx, get_dynamic_global_properties() );
+
+      for( const public_key_type& key : approving_key_set )
+         tx.sign( get_private_key(key), _chain_id );
 
       if( broadcast )
       {
          try
          {
-            _remote_net_broadcast->broadcast_transaction( tx );
+            send_to_network( tx );
          }
          catch (const fc::exception& e)
          {
@@ -2227,6 +2501,136 @@ public:
       return tx;
    }
 
+   /// Add the accounts whose active authorities tx requires, see get_local_required_keys
+   void add_authority_accounts( const transaction& tx, flat_set<string>& accounts )const
+   {
+      flat_set<account_id_type> active;
+      flat_set<account_id_type> owner;
+      vector<authority> other;
+      tx.get_required_authorities( active, owner, other );
+      for( const account_id_type& id : active )
+         accounts.insert( account_id_to_string( id ) );
+   }
+
+   /**
+    * Find the keys of this wallet which satisfy the authorities required by tx without asking the remote node.
+    * This is possible if only active authorities are required, and each of them is satisfied by a single key of
+    * this wallet.
+    */
+   optional< flat_set<public_key_type> > get_local_required_keys( const transaction& tx )const
+   {
+      flat_set<account_id_type> active;
+      flat_set<account_id_type> owner;
+      vector<authority> other;
+      tx.get_required_authorities( active, owner, other );
+      if( !owner.empty() || !other.empty() )
+         return {};
+
+      flat_set<public_key_type> result;
+      for( const account_id_type& id : active )
+      {
+         const account_object account = get_account( id );
+         const auto& key_auths = account.active.key_auths;
+         auto itr = std::find_if( key_auths.begin(), key_auths.end(),
+                                  [this,&account]( const pair<public_key_type, weight_type>& k ) {
+                                     return k.second >= account.active.weight_threshold && _keys.count( k.first );
+                                  } );
+         if( itr == key_auths.end() )
+            return {};
+         result.insert( itr->first );
+      }
+      return result;
+   }
+
+   vector<batch_transaction_result> sign_transactions( vector<signed_transaction> txs, uint32_t max_pending )
+   { try {
+      FC_ASSERT( !is_locked() );
+      FC_ASSERT( max_pending > 0 );
+
+      vector<batch_transaction_result> results( txs.size() );
+      vector< flat_set<public_key_type> > signing_keys( txs.size() );
+
+      // fetch the accounts whose authorities are needed at once
+      flat_set<string> authority_accounts;
+      for( const signed_transaction& tx : txs )
+         add_authority_accounts( tx, authority_accounts );
+      prefetch_accounts( vector<string>( authority_accounts.begin(), authority_accounts.end() ) );
+
+      const auto dyn_props = get_dynamic_global_properties();
+      map< public_key_type, fc::ecc::private_key > private_keys;
+      for( size_t i = 0; i < txs.size(); ++i )
+      {
+         try
+         {
+            auto local_keys = get_local_required_keys( txs[i] );
+            if( local_keys.valid() )
+               signing_keys[i] = std::move( *local_keys );
+            else
+            {
+               const auto remote_keys = get_owned_required_keys( txs[i] );
+               signing_keys[i].insert( remote_keys.begin(), remote_keys.end() );
+            }
+            set_unique_expiration( txs[i], dyn_props );
+            results[i].id = txs[i].id();
+            for( const public_key_type& key : signing_keys[i] )
+               if( private_keys.find( key ) == private_keys.end() )
+                  private_keys.emplace( key, get_private_key( key ) );
+         }
+         catch( const fc::exception& e )
+         {
+            results[i].error = e.to_string();
+         }
+      }
+
+      // the private keys are only read while signing
+      const uint32_t chunks = std::max<uint32_t>( 1u, fc::asio::default_io_service_scope::get_num_threads() );
+      const size_t chunk_size = ( txs.size() + chunks - 1 ) / chunks;
+      vector< fc::future<void> > signers;
+      for( size_t base = 0; base < txs.size(); base += chunk_size )
+         signers.push_back( fc::do_parallel( [this,&txs,&results,&signing_keys,&private_keys,base,chunk_size] () {
+            const size_t end = std::min( base + chunk_size, txs.size() );
+            for( size_t i = base; i < end; ++i )
+               if( !results[i].error.valid() )
+                  for( const public_key_type& key : signing_keys[i] )
+                     txs[i].sign( private_keys.at( key ), _chain_id );
+         } ) );
+      for( auto& signer : signers )
+         signer.wait();
+
+      // broadcast in windows, the broadcasts of a window wait for the node concurrently
+      size_t sent = 0;
+      size_t failed = 0;
+      for( size_t base = 0; base < txs.size(); base += max_pending )
+      {
+         const size_t end = std::min( base + max_pending, txs.size() );
+         vector< std::pair< size_t, fc::future<void> > > pending;
+         pending.reserve( end - base );
+         for( size_t i = base; i < end; ++i )
+            if( !results[i].error.valid() )
+               pending.emplace_back( i, fc::async( [this,&txs,i] () {
+                  _remote_net_broadcast->broadcast_transaction( txs[i] );
+               }, "sign_transactions broadcast" ) );
+         for( auto& item : pending )
+         {
+            try
+            {
+               item.second.wait();
+               results[item.first].broadcast = true;
+               ++sent;
+            }
+            catch( const fc::exception& e )
+            {
+               results[item.first].error = e.to_string();
+            }
+         }
+         failed = end - sent;
+         ilog( "Broadcast ${s} of ${n} transactions, ${f} failed", ("s", sent)("n", txs.size())("f", failed) );
+      }
+      _cache.forget_objects();
+
+      return results;
+   } FC_CAPTURE_AND_RETHROW( (max_pending) ) }
+
    flat_set<public_key_type> get_transaction_signers(const signed_transaction &tx) const
    {
       return tx.get_signature_keys(_chain_id);
@@ -2298,6 +2702,7 @@ public:
                                  bool   fill_or_kill = false,
                                  bool   broadcast = false)
    {
+      prefetch_assets( { symbol_to_sell, symbol_to_receive } );
       account_object seller   = get_account( seller_account );
 
       limit_order_create_operation op;
@@ -2310,7 +2715,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2331,7 +2736,7 @@ public:
 
       signed_transaction trx;
       trx.operations = {op};
-      set_operation_fees( trx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( trx, get_global_properties().parameters.get_current_fees());
       trx.validate();
 
       return sign_transaction(trx, broadcast);
@@ -2355,7 +2760,7 @@ public:
 
       signed_transaction trx;
       trx.operations = {op};
-      set_operation_fees( trx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( trx, get_global_properties().parameters.get_current_fees());
       trx.validate();
 
       return sign_transaction(trx, broadcast);
@@ -2370,7 +2775,7 @@ public:
          op.fee_paying_account = get_object(order_id).seller;
          op.order = order_id;
          trx.operations = {op};
-         set_operation_fees( trx, _remote_db->get_global_properties().parameters.get_current_fees());
+         set_operation_fees( trx, get_global_properties().parameters.get_current_fees());
 
          trx.validate();
          return sign_transaction(trx, broadcast);
@@ -2380,6 +2785,7 @@ public:
                                string asset_symbol, string memo, bool broadcast = false)
    { try {
       FC_ASSERT( !self.is_locked() );
+      prefetch_accounts( { from, to } );
       fc::optional<asset_object> asset_obj = get_asset(asset_symbol);
       FC_ASSERT(asset_obj, "Could not find asset matching ${asset}", ("asset", asset_symbol));
 
@@ -2405,7 +2811,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(xfer_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -2416,6 +2822,7 @@ public:
    {
       auto asset_obj = get_asset(symbol);
 
+      prefetch_accounts( { to_account, account_id_to_string( asset_obj.issuer ) } );
       account_object to = get_account(to_account);
       account_object issuer = get_account(asset_obj.issuer);
 
@@ -2435,7 +2842,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(issue_op);
-      set_operation_fees(tx,_remote_db->get_global_properties().parameters.get_current_fees());
+      set_operation_fees(tx,get_global_properties().parameters.get_current_fees());
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -2809,6 +3216,15 @@ public:
    {
       proposal_update_operation update_op;
 
+      vector<string> accounts{ fee_paying_account };
+      accounts.insert( accounts.end(), delta.active_approvals_to_add.begin(), delta.active_approvals_to_add.end() );
+      accounts.insert( accounts.end(), delta.active_approvals_to_remove.begin(),
+                       delta.active_approvals_to_remove.end() );
+      accounts.insert( accounts.end(), delta.owner_approvals_to_add.begin(), delta.owner_approvals_to_add.end() );
+      accounts.insert( accounts.end(), delta.owner_approvals_to_remove.begin(),
+                       delta.owner_approvals_to_remove.end() );
+      prefetch_accounts( accounts );
+
       update_op.fee_paying_account = get_account(fee_paying_account).id;
       update_op.proposal = fc::variant(proposal_id, 1).as<proposal_id_type>( 1 );
       // make sure the proposal exists
@@ -3006,6 +3422,8 @@ public:
 
    map<public_key_type,string> _keys;
    fc::sha512                  _checksum;
+   /// shards of @ref _keys changed since they were last encrypted
+   flat_set<uint32_t>          _dirty_key_shards;
 
    chain_id_type           _chain_id;
    fc::api<login_api>      _remote_api;
@@ -3568,7 +3986,12 @@ string wallet_api::serialize_transaction( signed_transaction tx )const
 
 variant wallet_api::get_object( object_id_type id ) const
 {
-   return my->_remote_db->get_objects({id});
+   return my->get_objects({id});
+}
+
+variant_object wallet_api::get_cache_statistics() const
+{
+   return my->get_cache_statistics();
 }
 
 string wallet_api::get_wallet_filename() const
@@ -4084,6 +4507,12 @@ signed_transaction wallet_api::sign_transaction(signed_transaction tx, bool broa
    return my->sign_transaction( tx, broadcast);
 } FC_CAPTURE_AND_RETHROW( (tx) ) }
 
+vector<batch_transaction_result> wallet_api::sign_transactions( vector<signed_transaction> txs,
+                                                                uint32_t max_pending /* = 100 */ )
+{
+   return my->sign_transactions( std::move( txs ), max_pending );
+}
+
 flat_set<public_key_type> wallet_api::get_transaction_signers(const signed_transaction &tx) const
 { try {
    return my->get_transaction_signers(tx);
@@ -4303,7 +4732,7 @@ bool wallet_api::is_locked()const
 }
 bool wallet_api::is_new()const
 {
-   return my->_wallet.cipher_keys.size() == 0;
+   return my->_wallet.cipher_keys.empty() && my->_wallet.cipher_key_shards.empty();
 }
 
 void wallet_api::encrypt_keys()
@@ -4326,11 +4755,24 @@ void wallet_api::unlock(string password)
 { try {
    FC_ASSERT(password.size() > 0);
    auto pw = fc::sha512::hash(password.c_str(), password.size());
-   vector<char> decrypted = fc::aes_decrypt(pw, my->_wallet.cipher_keys);
-   auto pk = fc::raw::unpack<plain_keys>(decrypted);
-   FC_ASSERT(pk.checksum == pw);
-   my->_keys = std::move(pk.keys);
-   my->_checksum = pk.checksum;
+   map<public_key_type,string> keys;
+   if( my->_wallet.cipher_key_shards.empty() )
+   {
+      // saved before the keys were sharded
+      vector<char> decrypted = fc::aes_decrypt(pw, my->_wallet.cipher_keys);
+      auto pk = fc::raw::unpack<plain_keys>(decrypted);
+      FC_ASSERT(pk.checksum == pw);
+      keys = std::move(pk.keys);
+   }
+   for( const vector<char>& shard : my->_wallet.cipher_key_shards )
+   {
+      vector<char> decrypted = fc::aes_decrypt(pw, shard);
+      auto pk = fc::raw::unpack<plain_keys>(decrypted);
+      FC_ASSERT(pk.checksum == pw);
+      keys.insert( pk.keys.begin(), pk.keys.end() );
+   }
+   my->_keys = std::move(keys);
+   my->_checksum = pw;
    my->self.lock_changed(false);
 } FC_CAPTURE_AND_RETHROW() }
 
@@ -4339,6 +4781,8 @@ void wallet_api::set_password( string password )
    if( !is_new() )
       FC_ASSERT( !is_locked(), "The wallet must be unlocked before the password can be set" );
    my->_checksum = fc::sha512::hash( password.c_str(), password.size() );
+   // every shard is encrypted again with the new password
+   my->_wallet.cipher_key_shards.clear();
    lock();
 }
 
@@ -4450,7 +4894,7 @@ vector< signed_transaction > wallet_api_impl::import_balance(
       tx.operations.reserve( ctx.ops.size() );
       for( const balance_claim_operation& op : ctx.ops )
          tx.operations.emplace_back( op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees() );
+      set_operation_fees( tx, get_global_properties().parameters.get_current_fees() );
       tx.validate();
       signed_transaction signed_tx = sign_transaction( tx, false );
       for( const address& addr : ctx.addrs )
@@ -4460,7 +4904,7 @@ vector< signed_transaction > wallet_api_impl::import_balance(
       boost::erase(signed_tx.signatures, boost::unique<boost::return_found_end>(boost::sort(signed_tx.signatures)));
       result.push_back( signed_tx );
       if( broadcast )
-         _remote_net_broadcast->broadcast_transaction(signed_tx);
+         send_to_network( signed_tx );
    }
 
    return result;
@@ -4597,7 +5041,7 @@ public_key_type    wallet_api::create_blind_account( string label, string brain_
 
    FC_ASSERT( set_key_label( pub_key, label ) );
 
-   my->_keys[pub_key] = graphene::utilities::key_to_wif( priv_key );
+   my->set_private_key( pub_key, graphene::utilities::key_to_wif( priv_key ) );
 
    save_wallet_file();
    return pub_key;
@@ -4645,7 +5089,7 @@ blind_confirmation wallet_api::transfer_from_blind( string from_blind_account_ke
    transfer_from_blind_operation from_blind;
 
 
-   auto fees  = my->_remote_db->get_global_properties().parameters.get_current_fees();
+   auto fees  = my->get_global_properties().parameters.get_current_fees();
    fc::optional<asset_object> asset_obj = get_asset(symbol);
    FC_ASSERT(asset_obj.valid(), "Could not find asset matching ${asset}", ("asset", symbol));
    auto amount = asset_obj->amount_from_string(amount_in);
@@ -4725,7 +5169,7 @@ blind_confirmation wallet_api::blind_transfer_help( string from_key_or_label,
    blind_transfer_operation blind_tr;
    blind_tr.outputs.resize(2);
 
-   auto fees  = my->_remote_db->get_global_properties().parameters.get_current_fees();
+   auto fees  = my->get_global_properties().parameters.get_current_fees();
 
    auto amount = asset_obj->amount_from_string(amount_in);
 
@@ -4953,7 +5397,7 @@ blind_confirmation wallet_api::transfer_to_blind( string from_account_id_or_name
               [&]( const blind_output& a, const blind_output& b ){ return a.commitment < b.commitment; } );
 
    confirm.trx.operations.push_back( bop );
-   my->set_operation_fees( confirm.trx, my->_remote_db->get_global_properties().parameters.get_current_fees());
+   my->set_operation_fees( confirm.trx, my->get_global_properties().parameters.get_current_fees());
    confirm.trx.validate();
    confirm.trx = sign_transaction(confirm.trx, broadcast);
 
@@ -5034,13 +5478,13 @@ blind_receipt wallet_api::receive_blind_transfer( string confirmation_receipt, s
 
    auto child_key_itr = owner.key_auths.find( child_pubkey );
    if( child_key_itr != owner.key_auths.end() )
-      my->_keys[child_key_itr->first] = key_to_wif( child_priv_key );
+      my->set_private_key( child_key_itr->first, key_to_wif( child_priv_key ) );
 
    // my->_wallet.blinded_balances[memo.amount.asset_id][bal.to].push_back( bal );
 
    result.date = fc::time_point::now();
    my->_wallet.blind_receipts.insert( result );
-   my->_keys[child_pubkey] = key_to_wif( child_priv_key );
+   my->set_private_key( child_pubkey, key_to_wif( child_priv_key ) );
 
    save_wallet_file();
 
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/chain/database.hpp>
+
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/global_property_object.hpp>
+#include <graphene/chain/market_object.hpp>
+
+#include "../common/database_fixture.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+   std::atomic<uint64_t> allocation_count{0};
+}
+
+// Count every heap allocation of the test executable, which is why these tests are built on their own
+void* operator new( std::size_t size )
+{
+   ++allocation_count;
+   if( void* p = std::malloc( size > 0 ? size : 1 ) )
+      return p;
+   throw std::bad_alloc();
+}
+void operator delete( void* p ) noexcept { std::free( p ); }
+void operator delete( void* p, std::size_t ) noexcept { std::free( p ); }
+
+namespace {
+   /**
+    * Upper bounds of the heap allocations per transaction pushed to the pending state. They are a few allocations
+    * above the current numbers, which vary slightly between standard libraries, so that a new allocation per
+    * modified object makes them fail. Lower them when the numbers logged by the test drop.
+    */
+   const uint64_t max_transfer_allocations           = 40;
+   const uint64_t max_limit_order_create_allocations = 55;
+   const uint64_t max_limit_order_cancel_allocations = 50;
+   /// Upper bound of the heap allocations of an undo session which modifies one object and is undone
+   const uint64_t max_undo_session_allocations       = 4;
+
+   /// Push the given transactions to the pending state, return the number of heap allocations per transaction
+   uint64_t push_and_count( database& db, const std::vector<signed_transaction>& transactions,
+                            std::vector<processed_transaction>* results = nullptr )
+   {
+      const uint64_t before = allocation_count.load();
+      for( const auto& tx : transactions )
+      {
+         if( results != nullptr )
+            results->emplace_back( db.push_transaction( tx, ~0 ) );
+         else
+            db.push_transaction( tx, ~0 );
+      }
+      return ( allocation_count.load() - before ) / transactions.size();
+   }
+}
+
+BOOST_FIXTURE_TEST_SUITE( allocation_tests, database_fixture )
+
+/**
+ * Check the number of heap allocations needed to push a transaction with a single operation of the most
+ * frequent types to the pending state. Each transaction is applied in its own undo session like incoming
+ * transactions are, so the numbers include the undo bookkeeping.
+ */
+BOOST_AUTO_TEST_CASE( operation_allocations )
+{ try {
+   ACTORS( (alice)(bob) );
+   fund( alice, asset(100000000) );
+   const asset_id_type test_asset = create_user_issued_asset( "ALLOC" ).id;
+
+   const uint32_t cycles = 1000;
+   std::vector<signed_transaction> transactions;
+   transactions.reserve( cycles );
+   std::vector<processed_transaction> results;
+   results.reserve( cycles );
+
+   auto add_transaction = [&]( operation op ) {
+      db.current_fee_schedule().set_fee( op );
+      trx.clear();
+      set_expiration( db, trx );
+      trx.operations.push_back( op );
+      transactions.push_back( trx );
+   };
+
+   for( uint32_t i = 0; i < cycles; ++i )
+   {
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset( i + 1 );
+      add_transaction( op );
+   }
+   const uint64_t transfer_allocations = push_and_count( db, transactions );
+   wlog( "transfer: ${n} allocations per operation", ("n",transfer_allocations) );
+   BOOST_CHECK_LE( transfer_allocations, max_transfer_allocations );
+
+   transactions.clear();
+   for( uint32_t i = 0; i < cycles; ++i )
+   {
+      limit_order_create_operation op;
+      op.seller = alice_id;
+      op.amount_to_sell = asset( i + 1 );
+      op.min_to_receive = asset( 1000000, test_asset );
+      op.expiration = time_point_sec::maximum();
+      add_transaction( op );
+   }
+   const uint64_t create_allocations = push_and_count( db, transactions, &results );
+   wlog( "limit_order_create: ${n} allocations per operation", ("n",create_allocations) );
+   BOOST_CHECK_LE( create_allocations, max_limit_order_create_allocations );
+
+   transactions.clear();
+   for( const auto& result : results )
+   {
+      limit_order_cancel_operation op;
+      op.fee_paying_account = alice_id;
+      op.order = result.operation_results[0].get<object_id_type>();
+      add_transaction( op );
+   }
+   const uint64_t cancel_allocations = push_and_count( db, transactions );
+   wlog( "limit_order_cancel: ${n} allocations per operation", ("n",cancel_allocations) );
+   BOOST_CHECK_LE( cancel_allocations, max_limit_order_cancel_allocations );
+   trx.clear();
+
+   BOOST_CHECK( db.get_index_type<limit_order_index>().indices().empty() );
+} FC_LOG_AND_RETHROW() }
+
+/**
+ * Check that undo sessions reuse the undo states of finished sessions, so that a session which modifies one object
+ * only allocates the copy of the object and its entry in the undo state.
+ */
+BOOST_AUTO_TEST_CASE( undo_session_allocations )
+{ try {
+   const uint32_t cycles = 1000;
+   auto modify_and_undo = [this]() {
+      auto session = db._undo_db.start_undo_session();
+      db.modify( db.get_dynamic_global_properties(), []( dynamic_global_property_object& dgp ) {
+         ++dgp.current_aslot;
+      });
+   };
+   // the first sessions create the undo states to be reused
+   modify_and_undo();
+
+   const uint64_t before = allocation_count.load();
+   for( uint32_t i = 0; i < cycles; ++i )
+      modify_and_undo();
+   const uint64_t session_allocations = ( allocation_count.load() - before ) / cycles;
+   wlog( "undo session: ${n} allocations per session", ("n",session_allocations) );
+   BOOST_CHECK_LE( session_allocations, max_undo_session_allocations );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/db_with.hpp>
+#include <graphene/chain/global_property_object.hpp>
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/workload_generator.hpp"
+
+#include <cstdlib>
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+namespace {
+
+/// The checks a node skips when it replays its own block database
+const uint32_t replay_skip_flags = database::skip_witness_signature |
+                                   database::skip_block_size_check |
+                                   database::skip_merkle_check |
+                                   database::skip_transaction_signatures |
+                                   database::skip_transaction_dupe_check |
+                                   database::skip_tapos_check |
+                                   database::skip_witness_schedule_check;
+
+/// Copies the block database in the data directory @p from to the data directory @p to
+void copy_blocks( const fc::path& from, const fc::path& to )
+{
+   const fc::path blocks = fc::path( "database" ) / "block_num_to_block";
+   fc::create_directories( to / blocks );
+   fc::copy( from / blocks / "index", to / blocks / "index" );
+   fc::copy( from / blocks / "blocks", to / blocks / "blocks" );
+}
+
+struct push_timing
+{
+   uint32_t regular_blocks = 0;
+   int64_t  regular_time = 0;
+   uint32_t maintenance_blocks = 0;
+   int64_t  maintenance_time = 0;
+   uint64_t operations = 0;
+};
+
+/// Pushes the blocks of @p source into a fresh database, and returns the microseconds spent in push_block
+push_timing time_push_blocks( const database& source, const genesis_state_type& genesis, uint32_t skip )
+{
+   fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+   database db;
+   db.open( data_dir.path(), [&genesis]{ return genesis; }, "replay" );
+
+   push_timing timing;
+   for( uint32_t num = 1; num <= source.head_block_num(); ++num )
+   {
+      const optional<signed_block> block = source.fetch_block_by_number( num );
+      FC_ASSERT( block.valid(), "Block ${n} is missing", ("n", num) );
+      const fc::time_point_sec next_maintenance = db.get_dynamic_global_properties().next_maintenance_time;
+
+      const fc::time_point start = fc::time_point::now();
+      db.push_block( *block, skip );
+      const int64_t elapsed = ( fc::time_point::now() - start ).count();
+
+      if( db.get_dynamic_global_properties().next_maintenance_time != next_maintenance )
+      {
+         ++timing.maintenance_blocks;
+         timing.maintenance_time += elapsed;
+      }
+      else
+      {
+         ++timing.regular_blocks;
+         timing.regular_time += elapsed;
+      }
+      for( const auto& trx : block->transactions )
+         timing.operations += trx.operations.size();
+   }
+   db.close();
+   return timing;
+}
+
+void report( const std::string& stage, const push_timing& timing )
+{
+   const int64_t total_time = std::max<int64_t>( timing.regular_time + timing.maintenance_time, 1 );
+   ilog( "push_block with ${s}: ${t} milliseconds, ${b} blocks/s, ${o} operations/s; "
+         "${r} regular blocks averaging ${ra} us, ${m} maintenance blocks averaging ${ma} us",
+         ("s", stage)("t", total_time / 1000)
+         ("b", uint64_t( timing.regular_blocks + timing.maintenance_blocks ) * 1000000 / total_time)
+         ("o", timing.operations * 1000000 / total_time)
+         ("r", timing.regular_blocks)("ra", timing.regular_time / std::max<uint32_t>( timing.regular_blocks, 1 ))
+         ("m", timing.maintenance_blocks)
+         ("ma", timing.maintenance_time / std::max<uint32_t>( timing.maintenance_blocks, 1 )) );
+}
+
+} // anonymous namespace
+
+/**
+ * Replays a block stream of generate_workload_blocks, taken from the data directory named by the
+ * GRAPHENE_WORKLOAD_DIR environment variable, or from a small workload generated on the fly.
+ */
+BOOST_AUTO_TEST_CASE( block_replay_bench )
+{
+   try {
+      fc::temp_directory workload_dir( graphene::utilities::temp_directory_path() );
+      fc::path source_dir;
+      genesis_state_type genesis;
+
+      const char* given_dir = std::getenv( "GRAPHENE_WORKLOAD_DIR" );
+      if( given_dir != nullptr )
+      {
+         source_dir = fc::path( given_dir ) / "db";
+         genesis = fc::json::from_file( fc::path( given_dir ) / "genesis.json" ).as< genesis_state_type >( 20 );
+      }
+      else
+      {
+         workload_options options;
+#ifdef NDEBUG
+         options.account_count = 2000;
+         const uint32_t blocks_to_generate = 2000;
+#else
+         options.account_count = 200;
+         const uint32_t blocks_to_generate = 200;
+#endif
+         workload_generator generator( options );
+         genesis = generator.genesis();
+         source_dir = workload_dir.path();
+
+         database db;
+         db.open( source_dir, [&genesis]{ return genesis; }, "workload" );
+         const fc::time_point start_time = fc::time_point::now();
+         generator.generate_setup_blocks( db );
+         for( uint32_t i = 0; i < blocks_to_generate; ++i )
+            generator.generate_block( db );
+         ilog( "Generated ${b} blocks with ${o} operations in ${t} milliseconds, ${r} transactions rejected",
+               ("b", db.head_block_num())("o", generator.operation_count())
+               ("t", (fc::time_point::now() - start_time).count() / 1000)
+               ("r", generator.rejected_transaction_count()) );
+         db.close();
+      }
+
+      fc::temp_directory replay_dir( graphene::utilities::temp_directory_path() );
+      copy_blocks( source_dir, replay_dir.path() );
+      database replayed;
+      fc::time_point start_time = fc::time_point::now();
+      graphene::chain::detail::with_skip_flags( replayed, replay_skip_flags, [&replayed,&replay_dir,&genesis]() {
+         replayed.open( replay_dir.path(), [&genesis]{ return genesis; }, "replay" );
+      });
+      const int64_t reindex_time = std::max<int64_t>( (fc::time_point::now() - start_time).count(), 1 );
+      const uint32_t block_count = replayed.head_block_num();
+      BOOST_REQUIRE_GT( block_count, 0u );
+      ilog( "Loaded genesis and reindexed ${n} blocks in ${t} milliseconds, ${b} blocks/s",
+            ("n", block_count)("t", reindex_time / 1000)("b", uint64_t( block_count ) * 1000000 / reindex_time) );
+
+      // each stage skips more of the checks, the differences between them are the cost of the skipped checks
+      const push_timing full = time_push_blocks( replayed, genesis, database::skip_nothing );
+      report( "full validation", full );
+      const push_timing unsigned_blocks = time_push_blocks( replayed, genesis, database::skip_transaction_signatures );
+      report( "transaction signatures skipped", unsigned_blocks );
+      const push_timing replay = time_push_blocks( replayed, genesis, replay_skip_flags );
+      report( "replay checks skipped", replay );
+
+      BOOST_CHECK_EQUAL( full.regular_blocks + full.maintenance_blocks, block_count );
+      BOOST_CHECK_EQUAL( full.operations, replay.operations );
+      BOOST_CHECK_EQUAL( full.maintenance_blocks, replay.maintenance_blocks );
+
+      replayed.close();
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+/**
+ * A generator which continues from the saved state of another one produces the same blocks as a generator
+ * which has not been stopped.
+ */
+BOOST_AUTO_TEST_CASE( workload_generator_state_test )
+{
+   try {
+      workload_options options;
+      options.account_count = 50;
+      options.transactions_per_block = 20;
+      options.mix.proposals = 30;
+      options.mix.htlcs = 30;
+      const uint32_t blocks_to_generate = 20;
+
+      // the genesis state of the first generator is used by all databases, as its timestamp depends on the time
+      workload_generator uninterrupted( options );
+      const genesis_state_type genesis = uninterrupted.genesis();
+      auto open = [&genesis]( database& db, const fc::temp_directory& dir ) {
+         db.open( dir.path(), [&genesis]{ return genesis; }, "workload" );
+      };
+
+      fc::temp_directory uninterrupted_dir( graphene::utilities::temp_directory_path() );
+      database uninterrupted_db;
+      open( uninterrupted_db, uninterrupted_dir );
+      uninterrupted.generate_setup_blocks( uninterrupted_db );
+      for( uint32_t i = 0; i < blocks_to_generate; ++i )
+         uninterrupted.generate_block( uninterrupted_db );
+
+      fc::temp_directory resumed_dir( graphene::utilities::temp_directory_path() );
+      const fc::path state_path = resumed_dir.path() / "generator_state.json";
+      database resumed_db;
+      open( resumed_db, resumed_dir );
+      {
+         workload_generator first_half( options );
+         first_half.generate_setup_blocks( resumed_db );
+         for( uint32_t i = 0; i < blocks_to_generate / 2; ++i )
+            first_half.generate_block( resumed_db );
+         first_half.save_state( resumed_db, state_path );
+      }
+      workload_generator second_half( options );
+      second_half.load_state( resumed_db, state_path );
+      for( uint32_t i = blocks_to_generate / 2; i < blocks_to_generate; ++i )
+         second_half.generate_block( resumed_db );
+
+      BOOST_REQUIRE_EQUAL( resumed_db.head_block_num(), uninterrupted_db.head_block_num() );
+      BOOST_CHECK_EQUAL( second_half.operation_count(), uninterrupted.operation_count() );
+      BOOST_CHECK_EQUAL( second_half.rejected_transaction_count(), uninterrupted.rejected_transaction_count() );
+      for( uint32_t num = 1; num <= uninterrupted_db.head_block_num(); ++num )
+      {
+         const signed_block expected = *uninterrupted_db.fetch_block_by_number( num );
+         const signed_block actual = *resumed_db.fetch_block_by_number( num );
+         BOOST_REQUIRE_EQUAL( actual.transactions.size(), expected.transactions.size() );
+         for( size_t i = 0; i < expected.transactions.size(); ++i )
+            BOOST_CHECK( fc::raw::pack( actual.transactions[i].operations )
+                         == fc::raw::pack( expected.transactions[i].operations ) );
+      }
+
+      // a state only fits the head block it was saved for
+      second_half.generate_block( resumed_db );
+      workload_generator stale( options );
+      BOOST_CHECK_THROW( stale.load_state( resumed_db, state_path ), fc::exception );
+
+      uninterrupted_db.close();
+      resumed_db.close();
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
@@ -23,12 +23,15 @@
  */
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/account_object.hpp>
+#include <graphene/chain/balance_object.hpp>
 #include <graphene/utilities/tempdir.hpp>
 
 #include <fc/crypto/digest.hpp>
 
 #include <boost/test/auto_unit_test.hpp>
 
+#include "../common/database_fixture.hpp"
+
 using namespace graphene::chain;
 
 BOOST_AUTO_TEST_CASE( operation_sanity_check )
@@ -127,3 +130,67 @@ BOOST_AUTO_TEST_CASE( genesis_and_persistence_bench )
       throw;
    }
 }
+
+BOOST_AUTO_TEST_CASE( genesis_bulk_load_bench )
+{
+   try {
+      genesis_state_type genesis_state;
+
+#ifdef NDEBUG
+      const int account_count = 200000;
+#else
+      const int account_count = 20000;
+#endif
+
+      genesis_state.initial_timestamp = fc::time_point_sec( GRAPHENE_TESTING_GENESIS_TIMESTAMP );
+      const auto init_key = fc::ecc::private_key::regenerate( fc::sha256::hash( string("null_key") ) ).get_public_key();
+      for( uint32_t i = 0; i < genesis_state.initial_active_witnesses; ++i )
+      {
+         const string name = "init" + fc::to_string(i);
+         genesis_state.initial_accounts.emplace_back( name, init_key );
+         genesis_state.initial_witness_candidates.push_back( { name, init_key } );
+      }
+      for( int i = 0; i < account_count; ++i )
+      {
+         const public_key_type key( fc::ecc::private_key::regenerate( fc::digest(i) ).get_public_key() );
+         genesis_state.initial_accounts.emplace_back( "bulk" + fc::to_string(i), key );
+         genesis_state.initial_balances.push_back( { address(key), GRAPHENE_SYMBOL, 1000 } );
+      }
+
+      fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+      database db;
+
+      fc::time_point start_time = fc::time_point::now();
+      db.open( data_dir.path(), [&]{ return genesis_state; }, "test" );
+      ilog( "Loaded genesis with ${n} accounts and balances in ${t} milliseconds.",
+            ("n", account_count)("t", (fc::time_point::now() - start_time).count() / 1000) );
+
+      // compare the bulk rebuild of the account member index with maintaining it one account at a time
+      const auto& accounts = db.get_index_type<account_index>();
+      const auto& members = dynamic_cast<const base_primary_index&>( accounts )
+                              .get_secondary_index<account_member_index>();
+
+      account_member_index incremental;
+      start_time = fc::time_point::now();
+      accounts.inspect_all_objects( [&incremental]( const object& o ) { incremental.object_inserted( o ); } );
+      ilog( "Inserted ${n} accounts into the member index in ${t} milliseconds.",
+            ("n", accounts.indices().size())("t", (fc::time_point::now() - start_time).count() / 1000) );
+
+      account_member_index rebuilt;
+      start_time = fc::time_point::now();
+      rebuilt.rebuild( accounts );
+      ilog( "Rebuilt the member index of ${n} accounts in ${t} milliseconds.",
+            ("n", accounts.indices().size())("t", (fc::time_point::now() - start_time).count() / 1000) );
+
+      BOOST_CHECK( members.account_to_key_memberships == incremental.account_to_key_memberships );
+      BOOST_CHECK( members.account_to_address_memberships == incremental.account_to_address_memberships );
+      BOOST_CHECK( members.account_to_account_memberships == incremental.account_to_account_memberships );
+      BOOST_CHECK( rebuilt.account_to_key_memberships == incremental.account_to_key_memberships );
+      BOOST_CHECK_EQUAL( db.get_index_type<balance_index>().indices().size(), size_t(account_count) );
+
+      db.close();
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
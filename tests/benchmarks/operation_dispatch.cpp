@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/protocol/operations.hpp>
+#include <graphene/protocol/variant_dispatch.hpp>
+
+#include <fc/log/logger.hpp>
+#include <fc/time.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+using namespace graphene::protocol;
+
+namespace {
+
+struct fee_payer_visitor
+{
+   typedef uint64_t result_type;
+
+   template<typename Op>
+   uint64_t operator()( const Op& op )const
+   {
+      return op.fee_payer().instance.value + op.fee.amount.value + sizeof(Op);
+   }
+};
+
+/// Runs @p visit over all operations @p rounds times, and returns the elapsed microseconds
+template<typename Visit>
+int64_t time_visits( const vector<operation>& ops, uint32_t rounds, uint64_t& checksum, Visit&& visit )
+{
+   checksum = 0;
+   const fc::time_point start = fc::time_point::now();
+   for( uint32_t r = 0; r < rounds; ++r )
+      for( const operation& op : ops )
+         checksum += visit( op );
+   return ( fc::time_point::now() - start ).count();
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( operation_dispatch_bench )
+{
+   try {
+#ifdef NDEBUG
+      const uint32_t rounds = 200000;
+#else
+      const uint32_t rounds = 10000;
+#endif
+
+      // one operation of every type, and the same number again with the types of the most common operations
+      vector<operation> ops;
+      for( int i = 0; i < operation::count(); ++i )
+      {
+         operation op;
+         op.set_which( i );
+         ops.push_back( op );
+      }
+      const int common[] = { operation::tag<transfer_operation>::value,
+                             operation::tag<limit_order_create_operation>::value,
+                             operation::tag<limit_order_cancel_operation>::value,
+                             operation::tag<asset_publish_feed_operation>::value };
+      for( int i = 0; i < operation::count(); ++i )
+      {
+         operation op;
+         op.set_which( common[ i % 4 ] );
+         ops.push_back( op );
+      }
+
+      uint64_t visit_checksum;
+      uint64_t dispatch_checksum;
+      const int64_t visit_time = time_visits( ops, rounds, visit_checksum, []( const operation& op ) {
+         return op.visit( fee_payer_visitor() );
+      });
+      const int64_t dispatch_time = time_visits( ops, rounds, dispatch_checksum, []( const operation& op ) {
+         return dispatch( op, fee_payer_visitor() );
+      });
+      BOOST_CHECK_EQUAL( visit_checksum, dispatch_checksum );
+
+      const uint64_t visits = uint64_t(rounds) * ops.size();
+      ilog( "Visited ${n} operations: static_variant::visit ${v} ms, dispatch table ${d} ms",
+            ("n",visits)("v",visit_time / 1000)("d",dispatch_time / 1000) );
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
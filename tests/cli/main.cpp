@@ -578,6 +578,94 @@ BOOST_FIXTURE_TEST_CASE( cli_cant_get_signers_from_modified_transaction, cli_fix
    }
 }
 
+///////////////////
+// Start a server and connect using the same calls as the CLI
+// Sign and broadcast several transactions at once, a failing one does not stop the others
+///////////////////
+BOOST_FIXTURE_TEST_CASE( cli_sign_transactions, cli_fixture )
+{
+   try {
+      INVOKE(create_new_account);
+
+      vector<signed_transaction> txs;
+      txs.push_back( con.wallet_api_ptr->transfer( "nathan", "jmjatlanta", "1", "1.3.0", "", false ) );
+      txs.push_back( con.wallet_api_ptr->transfer( "nathan", "jmjatlanta", "2", "1.3.0", "", false ) );
+      // jmjatlanta can not afford this one
+      txs.push_back( con.wallet_api_ptr->transfer( "jmjatlanta", "nathan", "1000000", "1.3.0", "", false ) );
+      // the same transfer again gets a different id
+      txs.push_back( txs.front() );
+
+      auto results = con.wallet_api_ptr->sign_transactions( txs, 2 );
+      BOOST_REQUIRE_EQUAL( results.size(), 4u );
+      BOOST_CHECK( results[0].broadcast && !results[0].error.valid() );
+      BOOST_CHECK( results[1].broadcast );
+      BOOST_CHECK( !results[2].broadcast && results[2].error.valid() );
+      BOOST_CHECK( results[3].broadcast );
+      BOOST_CHECK( results[0].id != results[3].id );
+
+      auto balances = con.wallet_api_ptr->list_account_balances( "jmjatlanta" );
+      BOOST_REQUIRE_EQUAL( balances.size(), 1u );
+      BOOST_CHECK_EQUAL( balances.front().amount.value, 1000000000 + 100000 + 200000 + 100000 );
+   } catch( fc::exception& e ) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+///////////////////
+// Start a server and connect using the same calls as the CLI
+// Look up objects repeatedly and check that the wallet serves them from its cache,
+// and that the cache is dropped after a broadcast and after a new block
+///////////////////
+BOOST_FIXTURE_TEST_CASE( cli_object_cache, cli_fixture )
+{
+   try {
+      INVOKE(create_new_account);
+
+      auto statistic = [this]( const string& name ) {
+         return con.wallet_api_ptr->get_cache_statistics()[name].as_uint64();
+      };
+      const object_id_type core_dynamic_data = asset_dynamic_data_id_type();
+
+      BOOST_TEST_MESSAGE("Looking up the same object twice");
+      uint64_t hits = statistic( "hits" );
+      uint64_t misses = statistic( "misses" );
+      con.wallet_api_ptr->get_object( core_dynamic_data );
+      con.wallet_api_ptr->get_object( core_dynamic_data );
+      BOOST_CHECK_EQUAL( statistic( "misses" ), misses + 1 );
+      BOOST_CHECK_EQUAL( statistic( "hits" ), hits + 1 );
+      BOOST_CHECK_GT( statistic( "objects" ), 0u );
+
+      BOOST_TEST_MESSAGE("Signing and broadcasting a builder transaction");
+      transfer_operation xfer;
+      xfer.from = con.wallet_api_ptr->get_account( "nathan" ).id;
+      xfer.to = con.wallet_api_ptr->get_account( "jmjatlanta" ).id;
+      xfer.amount = asset( 100000 );
+      auto handle = con.wallet_api_ptr->begin_builder_transaction();
+      con.wallet_api_ptr->add_operation_to_builder_transaction( handle, xfer );
+      con.wallet_api_ptr->set_fees_on_builder_transaction( handle, "1.3.0" );
+      // the accounts and properties needed for signing are cached already
+      misses = statistic( "misses" );
+      con.wallet_api_ptr->sign_builder_transaction( handle, true );
+      BOOST_CHECK_EQUAL( statistic( "misses" ), misses );
+      BOOST_CHECK_EQUAL( statistic( "objects" ), 0u );
+      con.wallet_api_ptr->get_object( core_dynamic_data );
+      BOOST_CHECK_EQUAL( statistic( "misses" ), misses + 1 );
+
+      BOOST_TEST_MESSAGE("Generating a block");
+      BOOST_CHECK( generate_block( app1 ) );
+      // wait for the block notification
+      fc::usleep( fc::seconds(1) );
+      BOOST_CHECK_EQUAL( statistic( "objects" ), 0u );
+      misses = statistic( "misses" );
+      con.wallet_api_ptr->get_object( core_dynamic_data );
+      BOOST_CHECK_EQUAL( statistic( "misses" ), misses + 1 );
+   } catch( fc::exception& e ) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 ///////////////////
 // Start a server and connect using the same calls as the CLI
 // Set a voting proxy and be assured that it sticks
@@ -868,6 +956,18 @@ graphene::wallet::plain_keys decrypt_keys( const std::string& password, const ve
    return fc::raw::unpack<graphene::wallet::plain_keys>( decrypted );
 }
 
+graphene::wallet::plain_keys decrypt_keys( const std::string& password, const graphene::wallet::wallet_data& wallet )
+{
+   graphene::wallet::plain_keys result;
+   for( const vector<char>& shard : wallet.cipher_key_shards )
+   {
+      graphene::wallet::plain_keys pk = decrypt_keys( password, shard );
+      result.checksum = pk.checksum;
+      result.keys.insert( pk.keys.begin(), pk.keys.end() );
+   }
+   return result;
+}
+
 BOOST_AUTO_TEST_CASE( saving_keys_wallet_test ) {
    cli_fixture cli;
 
@@ -884,8 +984,11 @@ BOOST_AUTO_TEST_CASE( saving_keys_wallet_test ) {
    BOOST_CHECK( wallet.pending_account_registrations.size() == 1 ); // account1
    BOOST_CHECK( wallet.pending_account_registrations["account1"].size() == 2 ); // account1 active key + account1 memo key
 
-   graphene::wallet::plain_keys pk = decrypt_keys( "supersecret", wallet.cipher_keys );
+   BOOST_CHECK( wallet.cipher_keys.empty() );
+   BOOST_CHECK( !wallet.cipher_key_shards.empty() );
+   graphene::wallet::plain_keys pk = decrypt_keys( "supersecret", wallet );
    BOOST_CHECK( pk.keys.size() == 1 ); // nathan key
+   const vector< vector<char> > shards_before = wallet.cipher_key_shards;
 
    BOOST_CHECK( generate_block( cli.app1 ) );
    fc::usleep( fc::seconds(1) );
@@ -895,8 +998,22 @@ BOOST_AUTO_TEST_CASE( saving_keys_wallet_test ) {
    BOOST_CHECK( wallet.pending_account_registrations.empty() );
    BOOST_CHECK_NO_THROW( cli.con.wallet_api_ptr->transfer( "account1", "nathan", "1000", "1.3.0", "", true ) );
 
-   pk = decrypt_keys( "supersecret", wallet.cipher_keys );
+   pk = decrypt_keys( "supersecret", wallet );
    BOOST_CHECK( pk.keys.size() == 3 ); // nathan key + account1 active key + account1 memo key
+
+   // only the shards of the two new keys were encrypted again
+   BOOST_REQUIRE_EQUAL( wallet.cipher_key_shards.size(), shards_before.size() );
+   size_t changed_shards = 0;
+   for( size_t i = 0; i < shards_before.size(); ++i )
+      if( wallet.cipher_key_shards[i] != shards_before[i] )
+         ++changed_shards;
+   BOOST_CHECK_LE( changed_shards, 2u );
+
+   // the keys survive locking and unlocking
+   cli.con.wallet_api_ptr->lock();
+   BOOST_CHECK_THROW( cli.con.wallet_api_ptr->unlock( "wrongpassword" ), fc::exception );
+   cli.con.wallet_api_ptr->unlock( "supersecret" );
+   BOOST_CHECK( cli.con.wallet_api_ptr->dump_private_keys() == pk.keys );
 }
 
 
@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "workload_generator.hpp"
+
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/balance_object.hpp>
+#include <graphene/chain/htlc_object.hpp>
+#include <graphene/chain/market_object.hpp>
+#include <graphene/chain/proposal_object.hpp>
+#include <graphene/chain/witness_object.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <cmath>
+#include <sstream>
+
+namespace graphene { namespace chain { namespace test {
+
+namespace {
+
+/// Operations per setup transaction, well below the default maximum transaction size
+const uint32_t setup_batch_size = 20;
+/// Setup transactions per block
+const uint32_t setup_transactions_per_block = 200;
+
+vector<double> zipf_weights( uint32_t count, double exponent )
+{
+   vector<double> weights( count );
+   for( uint32_t i = 0; i < count; ++i )
+      weights[i] = 1.0 / std::pow( double( i + 1 ), exponent );
+   return weights;
+}
+
+} // anonymous namespace
+
+workload_generator::workload_generator( const workload_options& options )
+   : _options( options ), _rng( options.seed )
+{
+   const workload_mix& mix = _options.mix;
+   FC_ASSERT( _options.account_count >= 2 && _options.account_count <= 100000,
+              "The workload needs between 2 and 100000 accounts" );
+   FC_ASSERT( _options.asset_count > 0, "The workload needs at least one user-issued asset" );
+   FC_ASSERT( _options.feed_producer_count > 0 && _options.feed_producer_count <= _options.account_count,
+              "The feed producers are picked from the workload accounts" );
+   FC_ASSERT( mix.transfers + mix.limit_orders + mix.price_feeds + mix.proposals + mix.account_updates + mix.htlcs > 0,
+              "The operation mix is empty" );
+
+   const vector<double> account_weights = zipf_weights( _options.account_count, _options.zipf_exponent );
+   const vector<double> asset_weights = zipf_weights( _options.asset_count, _options.zipf_exponent );
+   _account_dist = std::discrete_distribution<uint32_t>( account_weights.begin(), account_weights.end() );
+   _asset_dist = std::discrete_distribution<uint32_t>( asset_weights.begin(), asset_weights.end() );
+   _mix_dist = std::discrete_distribution<uint32_t>( { double( mix.transfers ), double( mix.limit_orders ),
+                                                       double( mix.price_feeds ), double( mix.proposals ),
+                                                       double( mix.account_updates ), double( mix.htlcs ) } );
+
+   chain_parameters& params = _genesis.initial_parameters;
+   params.get_mutable_fees() = fee_schedule::get_default();
+   params.maintenance_interval = _options.maintenance_interval;
+   params.extensions.value.updatable_htlc_options = htlc_options{ 60 * 60 * 24, 1024 };
+   if( _options.genesis_time != fc::time_point_sec() )
+      _genesis.initial_timestamp = _options.genesis_time;
+   else
+      _genesis.initial_timestamp = fc::time_point_sec( fc::time_point::now().sec_since_epoch()
+                                                       / params.block_interval * params.block_interval );
+
+   const public_key_type init_key = witness_key().get_public_key();
+   for( uint64_t i = 0; i < _genesis.initial_active_witnesses; ++i )
+   {
+      const string name = "init" + std::to_string( i );
+      _genesis.initial_accounts.emplace_back( name, init_key, init_key, true );
+      _genesis.initial_committee_candidates.push_back( { name } );
+      _genesis.initial_witness_candidates.push_back( { name, init_key } );
+   }
+
+   // half of the supply follows the account weights, every account gets enough for a long run of fees
+   const share_type minimum_balance = 10000 * GRAPHENE_BLOCKCHAIN_PRECISION;
+   const vector<double>& shares = _account_dist.probabilities();
+   _keys.reserve( _options.account_count );
+   for( uint32_t i = 0; i < _options.account_count; ++i )
+   {
+      _keys.push_back( account_key( i ) );
+      const public_key_type key = _keys.back().get_public_key();
+      _genesis.initial_accounts.emplace_back( account_name( i ), key );
+      const share_type balance( int64_t( double( GRAPHENE_MAX_SHARE_SUPPLY / 2 ) * shares[i] ) );
+      _genesis.initial_balances.push_back( { address( key ), GRAPHENE_SYMBOL, std::max( balance, minimum_balance ) } );
+   }
+   _genesis.initial_chain_id = fc::sha256::hash( "workload" + std::to_string( _options.seed ) );
+}
+
+fc::ecc::private_key workload_generator::account_key( uint32_t account )
+{
+   return fc::ecc::private_key::regenerate( fc::sha256::hash( account_name( account ) ) );
+}
+
+fc::ecc::private_key workload_generator::witness_key()
+{
+   return fc::ecc::private_key::regenerate( fc::sha256::hash( string( "null_key" ) ) );
+}
+
+string workload_generator::account_name( uint32_t account )
+{
+   return "workload" + std::to_string( account );
+}
+
+string workload_generator::asset_symbol( uint32_t asset )
+{
+   string symbol = "WLOAD";
+   do
+   {
+      symbol += char( 'A' + asset % 26 );
+      asset /= 26;
+   } while( asset > 0 );
+   return symbol;
+}
+
+workload_generator_state workload_generator::get_state( const database& db )const
+{
+   workload_generator_state state;
+   state.head_block_id = db.head_block_id();
+   std::ostringstream rng;
+   rng << _rng;
+   state.rng = rng.str();
+   state.pending_proposals.assign( _pending_proposals.begin(), _pending_proposals.end() );
+   for( const pending_htlc& htlc : _pending_htlcs )
+      state.pending_htlcs.push_back( { htlc.id, htlc.preimage } );
+   state.operation_count = _operation_count;
+   state.rejected_count = _rejected_count;
+   return state;
+}
+
+void workload_generator::set_state( const database& db, const workload_generator_state& state )
+{
+   FC_ASSERT( state.head_block_id == db.head_block_id(),
+              "The generator state belongs to block ${s}, the head block is ${h}",
+              ("s", state.head_block_id)("h", db.head_block_id()) );
+   std::istringstream rng( state.rng );
+   rng >> _rng;
+   FC_ASSERT( !rng.fail(), "Invalid random number generator state" );
+   _pending_proposals.assign( state.pending_proposals.begin(), state.pending_proposals.end() );
+   _pending_htlcs.clear();
+   for( const workload_generator_state::htlc& htlc : state.pending_htlcs )
+      _pending_htlcs.push_back( { htlc.id, htlc.preimage } );
+   _operation_count = state.operation_count;
+   _rejected_count = state.rejected_count;
+}
+
+void workload_generator::save_state( const database& db, const fc::path& path )const
+{
+   fc::json::save_to_file( get_state( db ), path );
+}
+
+void workload_generator::load_state( const database& db, const fc::path& path )
+{
+   set_state( db, fc::json::from_file( path ).as< workload_generator_state >( GRAPHENE_MAX_NESTED_OBJECTS ) );
+}
+
+void workload_generator::resolve_objects( const database& db )
+{
+   const auto& accounts_by_name = db.get_index_type<account_index>().indices().get<by_name>();
+   _accounts.clear();
+   _account_numbers.clear();
+   for( uint32_t i = 0; i < _options.account_count; ++i )
+   {
+      auto itr = accounts_by_name.find( account_name( i ) );
+      FC_ASSERT( itr != accounts_by_name.end(), "Workload account ${a} is missing", ("a", account_name( i )) );
+      _accounts.push_back( itr->id );
+      _account_numbers[ itr->id ] = i;
+   }
+
+   _witness_votes.clear();
+   for( const witness_object& witness : db.get_index_type<witness_index>().indices() )
+      _witness_votes.push_back( witness.vote_id );
+
+   // the assets only exist once the setup blocks are generated
+   const auto& assets_by_symbol = db.get_index_type<asset_index>().indices().get<by_symbol>();
+   _uias.clear();
+   for( uint32_t i = 0; i < _options.asset_count; ++i )
+   {
+      auto itr = assets_by_symbol.find( asset_symbol( i ) );
+      if( itr == assets_by_symbol.end() )
+      {
+         _uias.clear();
+         return;
+      }
+      _uias.push_back( itr->id );
+   }
+   auto itr = assets_by_symbol.find( asset_symbol( _options.asset_count ) );
+   FC_ASSERT( itr != assets_by_symbol.end(), "The market-issued workload asset is missing" );
+   _mpa = itr->id;
+}
+
+uint32_t workload_generator::generate_setup_blocks( database& db )
+{
+   resolve_objects( db );
+   FC_ASSERT( _uias.empty(), "The workload setup has already been done in this database" );
+
+   uint32_t blocks = 0;
+   uint32_t pushed = 0;
+   auto flush = [&]() {
+      if( pushed == 0 )
+         return;
+      produce_block( db );
+      ++blocks;
+      pushed = 0;
+   };
+   auto push_setup = [&]( vector<operation> ops, uint32_t signer ) {
+      push( db, std::move( ops ), { signer } );
+      if( ++pushed == setup_transactions_per_block )
+         flush();
+   };
+
+   // claim the genesis balances
+   const auto& balances_by_owner = db.get_index_type<balance_index>().indices().get<by_owner>();
+   for( uint32_t i = 0; i < _options.account_count; ++i )
+   {
+      const public_key_type key = _keys[i].get_public_key();
+      auto itr = balances_by_owner.find( boost::make_tuple( address( key ), asset_id_type() ) );
+      FC_ASSERT( itr != balances_by_owner.end() );
+      balance_claim_operation op;
+      op.deposit_to_account = _accounts[i];
+      op.balance_to_claim = itr->id;
+      op.balance_owner_key = key;
+      op.total_claimed = itr->balance;
+      push_setup( { op }, i );
+   }
+   flush();
+
+   // the richest account issues all assets, the last one is market-issued and backed by core
+   const uint32_t issuer = 0;
+   for( uint32_t i = 0; i <= _options.asset_count; ++i )
+   {
+      asset_create_operation op;
+      op.issuer = _accounts[issuer];
+      op.symbol = asset_symbol( i );
+      op.precision = 2 + i % 5;
+      op.common_options.max_supply = GRAPHENE_MAX_SHARE_SUPPLY;
+      op.common_options.market_fee_percent = 10 * ( i % 5 );
+      op.common_options.flags = charge_market_fee;
+      op.common_options.issuer_permissions = charge_market_fee;
+      op.common_options.core_exchange_rate = price( asset( 1, asset_id_type(1) ), asset( 1 ) );
+      if( i == _options.asset_count )
+      {
+         op.precision = GRAPHENE_BLOCKCHAIN_PRECISION_DIGITS;
+         op.bitasset_opts = bitasset_options();
+      }
+      push_setup( { op }, issuer );
+   }
+   flush();
+   resolve_objects( db );
+
+   asset_update_feed_producers_operation producers;
+   producers.issuer = _accounts[issuer];
+   producers.asset_to_update = _mpa;
+   for( uint32_t i = 0; i < _options.feed_producer_count; ++i )
+      producers.new_feed_producers.insert( _accounts[i] );
+   push_setup( { producers }, issuer );
+
+   // hand out the user-issued assets with the same skew as the core balances
+   const vector<double>& shares = _account_dist.probabilities();
+   for( const asset_id_type uia : _uias )
+   {
+      vector<operation> ops;
+      for( uint32_t i = 0; i < _options.account_count; ++i )
+      {
+         asset_issue_operation op;
+         op.issuer = _accounts[issuer];
+         op.asset_to_issue = units( db, uia, 1000 );
+         op.asset_to_issue.amount += share_type( int64_t( double( GRAPHENE_MAX_SHARE_SUPPLY / 100 ) * shares[i] ) );
+         op.issue_to_account = _accounts[i];
+         ops.push_back( op );
+         if( ops.size() == setup_batch_size )
+            push_setup( std::move( ops ), issuer );
+      }
+      if( !ops.empty() )
+         push_setup( std::move( ops ), issuer );
+   }
+
+   for( uint32_t i = 0; i < _options.feed_producer_count; ++i )
+      push_setup( { make_price_feed( db, i ) }, i );
+   flush();
+
+   return blocks;
+}
+
+signed_block workload_generator::generate_block( database& db )
+{
+   if( _uias.empty() )
+   {
+      resolve_objects( db );
+      FC_ASSERT( !_uias.empty(), "The workload setup blocks have not been generated" );
+   }
+
+   for( uint32_t i = 0; i < _options.transactions_per_block; ++i )
+   {
+      switch( _mix_dist( _rng ) )
+      {
+         case 0: add_transfer( db ); break;
+         case 1: add_limit_order( db ); break;
+         case 2: add_price_feed( db ); break;
+         case 3: add_proposal( db ); break;
+         case 4: add_account_update( db ); break;
+         default: add_htlc( db ); break;
+      }
+   }
+   return produce_block( db );
+}
+
+signed_block workload_generator::produce_block( database& db )
+{
+   signed_block block = db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1), witness_key(),
+                                           database::skip_nothing );
+   for( const auto& trx : block.transactions )
+      _operation_count += trx.operations.size();
+   return block;
+}
+
+processed_transaction workload_generator::push( database& db, vector<operation> ops, const vector<uint32_t>& signers )
+{
+   signed_transaction trx;
+   trx.operations = std::move( ops );
+   for( operation& op : trx.operations )
+      db.current_fee_schedule().set_fee( op );
+   trx.set_reference_block( db.head_block_id() );
+   trx.set_expiration( db.head_block_time() + fc::minutes( 10 ) );
+   for( uint32_t signer : signers )
+      trx.sign( _keys[signer], db.get_chain_id() );
+   return db.push_transaction( trx );
+}
+
+optional<processed_transaction> workload_generator::try_push( database& db, vector<operation> ops,
+                                                              const vector<uint32_t>& signers )
+{
+   try
+   {
+      return push( db, std::move( ops ), signers );
+   }
+   catch( const fc::exception& e )
+   {
+      dlog( "Workload transaction rejected: ${e}", ("e", e.to_string()) );
+      ++_rejected_count;
+      return optional<processed_transaction>();
+   }
+}
+
+void workload_generator::add_transfer( database& db )
+{
+   const uint32_t from = pick_account();
+   transfer_operation op;
+   op.from = _accounts[from];
+   op.to = _accounts[ pick_other_account( from ) ];
+   // most transfers move core
+   const asset_id_type asset_id = random_int( 0, 9 ) < 7 ? asset_id_type() : pick_asset();
+   op.amount = units( db, asset_id, random_int( 1, 100 ) );
+   try_push( db, { op }, { from } );
+}
+
+void workload_generator::add_limit_order( database& db )
+{
+   const uint32_t seller = pick_account();
+   if( random_int( 0, 4 ) == 0 )
+   {
+      const auto& orders_by_account = db.get_index_type<limit_order_index>().indices().get<by_account>();
+      auto itr = orders_by_account.lower_bound( _accounts[seller] );
+      if( itr != orders_by_account.end() && itr->seller == _accounts[seller] )
+      {
+         limit_order_cancel_operation op;
+         op.fee_paying_account = itr->seller;
+         op.order = itr->id;
+         try_push( db, { op }, { seller } );
+         return;
+      }
+   }
+
+   // trade a user-issued asset against core, with prices scattered around one unit for one unit so that
+   // some of the orders match
+   const asset_id_type uia = pick_asset();
+   const int64_t count = random_int( 1, 50 );
+   const int64_t counter_count = count * random_int( 95, 105 ) / 100 + 1;
+   limit_order_create_operation op;
+   op.seller = _accounts[seller];
+   if( random_int( 0, 1 ) == 0 )
+   {
+      op.amount_to_sell = units( db, uia, count );
+      op.min_to_receive = units( db, asset_id_type(), counter_count );
+   }
+   else
+   {
+      op.amount_to_sell = units( db, asset_id_type(), count );
+      op.min_to_receive = units( db, uia, counter_count );
+   }
+   op.expiration = db.head_block_time() + fc::days( 7 );
+   try_push( db, { op }, { seller } );
+}
+
+asset_publish_feed_operation workload_generator::make_price_feed( const database& db, uint32_t producer )
+{
+   asset_publish_feed_operation op;
+   op.publisher = _accounts[producer];
+   op.asset_id = _mpa;
+   op.feed.settlement_price = price( units( db, _mpa, 1 ), units( db, asset_id_type(), random_int( 190, 210 ) ) );
+   op.feed.core_exchange_rate = op.feed.settlement_price;
+   return op;
+}
+
+void workload_generator::add_price_feed( database& db )
+{
+   const uint32_t producer = random_int( 0, _options.feed_producer_count - 1 );
+   try_push( db, { make_price_feed( db, producer ) }, { producer } );
+}
+
+void workload_generator::add_proposal( database& db )
+{
+   if( !_pending_proposals.empty() && random_int( 0, 1 ) == 0 )
+   {
+      const proposal_id_type id = _pending_proposals.front();
+      _pending_proposals.pop_front();
+      const proposal_object* proposal = db.find( id );
+      if( proposal == nullptr || proposal->required_active_approvals.empty() )
+         return;
+      const account_id_type approver = *proposal->required_active_approvals.begin();
+      proposal_update_operation op;
+      op.fee_paying_account = approver;
+      op.proposal = id;
+      op.active_approvals_to_add.insert( approver );
+      try_push( db, { op }, { account_of( approver ) } );
+      return;
+   }
+
+   const uint32_t from = pick_account();
+   transfer_operation transfer;
+   transfer.from = _accounts[from];
+   transfer.to = _accounts[ pick_other_account( from ) ];
+   transfer.amount = units( db, asset_id_type(), random_int( 1, 10 ) );
+   operation proposed = transfer;
+   db.current_fee_schedule().set_fee( proposed );
+
+   proposal_create_operation op;
+   op.fee_paying_account = transfer.from;
+   op.proposed_ops.emplace_back( proposed );
+   op.expiration_time = db.head_block_time() + fc::days( 1 );
+   optional<processed_transaction> ptx = try_push( db, { op }, { from } );
+   if( ptx.valid() )
+      _pending_proposals.push_back( proposal_id_type( ptx->operation_results.front().get<object_id_type>() ) );
+}
+
+void workload_generator::add_account_update( database& db )
+{
+   const uint32_t account = pick_account();
+   account_update_operation op;
+   op.account = _accounts[account];
+   account_options options = op.account( db ).options;
+   options.votes.clear();
+   const int64_t vote_count = random_int( 1, std::min<int64_t>( 5, _witness_votes.size() ) );
+   for( int64_t i = 0; i < vote_count; ++i )
+      options.votes.insert( _witness_votes[ random_int( 0, _witness_votes.size() - 1 ) ] );
+   options.num_witness = 0;
+   options.num_committee = 0;
+   if( random_int( 0, 3 ) == 0 )
+      options.memo_key = _keys[ pick_account() ].get_public_key();
+   op.new_options = options;
+   try_push( db, { op }, { account } );
+}
+
+void workload_generator::add_htlc( database& db )
+{
+   if( !_pending_htlcs.empty() && random_int( 0, 1 ) == 0 )
+   {
+      pending_htlc pending = std::move( _pending_htlcs.front() );
+      _pending_htlcs.pop_front();
+      const htlc_object* htlc = db.find( pending.id );
+      if( htlc == nullptr )
+         return;
+      htlc_redeem_operation op;
+      op.htlc_id = pending.id;
+      op.redeemer = htlc->transfer.to;
+      op.preimage = std::move( pending.preimage );
+      try_push( db, { op }, { account_of( op.redeemer ) } );
+      return;
+   }
+
+   const uint32_t from = pick_account();
+   std::vector<char> preimage( 32 );
+   for( char& c : preimage )
+      c = char( random_int( 0, 255 ) );
+   htlc_create_operation op;
+   op.from = _accounts[from];
+   op.to = _accounts[ pick_other_account( from ) ];
+   op.amount = units( db, asset_id_type(), random_int( 1, 10 ) );
+   op.preimage_hash = fc::sha256::hash( preimage.data(), preimage.size() );
+   op.preimage_size = preimage.size();
+   op.claim_period_seconds = 60 * 60;
+   optional<processed_transaction> ptx = try_push( db, { op }, { from } );
+   if( ptx.valid() )
+      _pending_htlcs.push_back( { htlc_id_type( ptx->operation_results.front().get<object_id_type>() ),
+                                  std::move( preimage ) } );
+}
+
+int64_t workload_generator::random_int( int64_t low, int64_t high )
+{
+   return std::uniform_int_distribution<int64_t>( low, high )( _rng );
+}
+
+uint32_t workload_generator::pick_account()
+{
+   return _account_dist( _rng );
+}
+
+uint32_t workload_generator::pick_other_account( uint32_t account )
+{
+   uint32_t other = pick_account();
+   while( other == account )
+      other = pick_account();
+   return other;
+}
+
+asset_id_type workload_generator::pick_asset()
+{
+   return _uias[ _asset_dist( _rng ) ];
+}
+
+uint32_t workload_generator::account_of( account_id_type id )const
+{
+   auto itr = _account_numbers.find( id );
+   FC_ASSERT( itr != _account_numbers.end(), "${id} is not a workload account", ("id", id) );
+   return itr->second;
+}
+
+asset workload_generator::units( const database& db, asset_id_type asset_id, int64_t count )
+{
+   return asset( asset::scaled_precision( asset_id( db ).precision ).value * count, asset_id );
+}
+
+} } } // graphene::chain::test
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/genesis_state.hpp>
+
+#include <deque>
+#include <random>
+
+namespace graphene { namespace chain { namespace test {
+
+/// Relative frequencies of the operation kinds in a generated workload
+struct workload_mix
+{
+   uint32_t transfers       = 50; ///< core and UIA transfers
+   uint32_t limit_orders    = 25; ///< limit order creation and cancellation
+   uint32_t price_feeds     = 5;  ///< feeds of the market-issued asset
+   uint32_t proposals       = 5;  ///< proposed transfers and their approvals
+   uint32_t account_updates = 5;  ///< witness votes and memo key changes
+   uint32_t htlcs           = 10; ///< HTLC creation and redemption
+};
+
+struct workload_options
+{
+   uint32_t account_count          = 1000;
+   uint32_t asset_count            = 10;   ///< user-issued assets; one market-issued asset is created as well
+   uint32_t feed_producer_count    = 5;
+   uint32_t transactions_per_block = 50;
+   /// Exponent of the Zipf distributions of balances and activity over accounts, and of activity over assets
+   double   zipf_exponent          = 1.0;
+   uint64_t seed                   = 0;
+   /// Rounded-down current time when not set
+   fc::time_point_sec genesis_time;
+   /// Shorter than the mainnet default so that modest workloads cross several maintenance intervals
+   uint32_t maintenance_interval   = 600;
+   workload_mix mix;
+};
+
+/// The state of a workload_generator which is not kept by the database, see workload_generator::save_state()
+struct workload_generator_state
+{
+   struct htlc
+   {
+      htlc_id_type      id;
+      std::vector<char> preimage;
+   };
+
+   /// The head block the state belongs to
+   block_id_type            head_block_id;
+   /// The textual state of the random number generator
+   string                   rng;
+   vector<proposal_id_type> pending_proposals;
+   vector<htlc>             pending_htlcs;
+   uint64_t                 operation_count = 0;
+   uint64_t                 rejected_count = 0;
+};
+
+/**
+ * @brief Produces a reproducible stream of blocks with a realistic mix of operations
+ *
+ * The workload accounts receive their stake in the genesis state with a Zipf distribution, so that a few
+ * accounts hold most of it, and the same distribution decides how often each account and asset shows up in
+ * the generated transactions.  All keys are derived from the account names, so any block stream produced
+ * from the same options can be replayed.
+ *
+ * The caller opens a database with @ref genesis(), then runs @ref generate_setup_blocks() once before
+ * generating the workload itself with @ref generate_block().  To extend the stream later, the caller saves
+ * the generator with @ref save_state() and loads it into a generator created with the same options; the
+ * blocks which follow are the same as if the generator had not been stopped.
+ */
+class workload_generator
+{
+public:
+   explicit workload_generator( const workload_options& options );
+
+   const genesis_state_type& genesis()const { return _genesis; }
+   const workload_options& options()const { return _options; }
+
+   /// Claims the genesis balances, creates and distributes the assets and publishes initial feeds
+   /// @return the number of blocks generated
+   uint32_t generate_setup_blocks( database& db );
+
+   /// Pushes options().transactions_per_block random transactions and produces the next block with them
+   signed_block generate_block( database& db );
+
+   /// Operations included in the generated blocks
+   uint64_t operation_count()const { return _operation_count; }
+   /// Transactions that failed to apply when pushed, e.g. due to an exhausted balance
+   uint64_t rejected_transaction_count()const { return _rejected_count; }
+
+   /// @return the random number generator, the pending proposals and HTLCs and the counters, as of the head
+   ///         block of @p db
+   workload_generator_state get_state( const database& db )const;
+   /// Continues from a state returned by get_state(), which must belong to the head block of @p db
+   void set_state( const database& db, const workload_generator_state& state );
+   /// Writes get_state() to a JSON file
+   void save_state( const database& db, const fc::path& path )const;
+   /// Reads a file written by save_state() and continues from it
+   void load_state( const database& db, const fc::path& path );
+
+   static fc::ecc::private_key account_key( uint32_t account );
+   static fc::ecc::private_key witness_key();
+   static string account_name( uint32_t account );
+   static string asset_symbol( uint32_t asset );
+
+private:
+   struct pending_htlc
+   {
+      htlc_id_type      id;
+      std::vector<char> preimage;
+   };
+
+   void resolve_objects( const database& db );
+   signed_block produce_block( database& db );
+   processed_transaction push( database& db, vector<operation> ops, const vector<uint32_t>& signers );
+   /// Like push(), but counts a failing transaction as rejected instead of throwing
+   optional<processed_transaction> try_push( database& db, vector<operation> ops, const vector<uint32_t>& signers );
+
+   void add_transfer( database& db );
+   void add_limit_order( database& db );
+   void add_price_feed( database& db );
+   void add_proposal( database& db );
+   void add_account_update( database& db );
+   void add_htlc( database& db );
+
+   asset_publish_feed_operation make_price_feed( const database& db, uint32_t producer );
+
+   int64_t random_int( int64_t low, int64_t high );
+   uint32_t pick_account();
+   uint32_t pick_other_account( uint32_t account );
+   asset_id_type pick_asset();
+   uint32_t account_of( account_id_type id )const;
+   static asset units( const database& db, asset_id_type asset_id, int64_t count );
+
+   workload_options                         _options;
+   genesis_state_type                       _genesis;
+   std::mt19937_64                          _rng;
+   std::discrete_distribution<uint32_t>     _account_dist;
+   std::discrete_distribution<uint32_t>     _asset_dist;
+   std::discrete_distribution<uint32_t>     _mix_dist;
+   vector<fc::ecc::private_key>             _keys;
+
+   vector<account_id_type>                  _accounts;
+   flat_map<account_id_type, uint32_t>      _account_numbers;
+   vector<asset_id_type>                    _uias;
+   asset_id_type                            _mpa;
+   vector<vote_id_type>                     _witness_votes;
+   std::deque<proposal_id_type>             _pending_proposals;
+   std::deque<pending_htlc>                 _pending_htlcs;
+
+   uint64_t                                 _operation_count = 0;
+   uint64_t                                 _rejected_count = 0;
+};
+
+} } } // graphene::chain::test
+
+FC_REFLECT( graphene::chain::test::workload_generator_state::htlc, (id)(preimage) )
+FC_REFLECT( graphene::chain::test::workload_generator_state,
+            (head_block_id)(rng)(pending_proposals)(pending_htlcs)(operation_count)(rejected_count) )
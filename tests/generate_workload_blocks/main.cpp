@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 BitShares Blockchain Foundation, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <iostream>
+
+#include <fc/io/json.hpp>
+
+#include <graphene/chain/database.hpp>
+
+#include "../common/workload_generator.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+using namespace std;
+namespace bpo = boost::program_options;
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      workload_options defaults;
+      bpo::options_description cli_options("Graphene workload blocks");
+      cli_options.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("data-dir", bpo::value<boost::filesystem::path>()->default_value("workload_blocks_data_dir"),
+                  "Directory receiving genesis.json and the generator database")
+            ("num-blocks,n", bpo::value<uint32_t>()->default_value(10000), "Number of workload blocks to generate")
+            ("accounts", bpo::value<uint32_t>()->default_value(defaults.account_count), "Number of accounts")
+            ("assets", bpo::value<uint32_t>()->default_value(defaults.asset_count), "Number of user-issued assets")
+            ("feed-producers", bpo::value<uint32_t>()->default_value(defaults.feed_producer_count),
+                  "Number of price feed producers")
+            ("tx-per-block", bpo::value<uint32_t>()->default_value(defaults.transactions_per_block),
+                  "Transactions pushed per block")
+            ("zipf-exponent", bpo::value<double>()->default_value(defaults.zipf_exponent),
+                  "Skew of balances and activity over accounts and assets")
+            ("seed", bpo::value<uint64_t>()->default_value(defaults.seed), "Random seed")
+            ("genesis-time,t", bpo::value<uint32_t>()->default_value(0), "Timestamp for genesis state (0=now)")
+            ("maintenance-interval", bpo::value<uint32_t>()->default_value(defaults.maintenance_interval),
+                  "Maintenance interval in seconds")
+            ("transfer-weight", bpo::value<uint32_t>()->default_value(defaults.mix.transfers),
+                  "Relative frequency of transfers")
+            ("limit-order-weight", bpo::value<uint32_t>()->default_value(defaults.mix.limit_orders),
+                  "Relative frequency of limit order creations and cancellations")
+            ("feed-weight", bpo::value<uint32_t>()->default_value(defaults.mix.price_feeds),
+                  "Relative frequency of price feeds")
+            ("proposal-weight", bpo::value<uint32_t>()->default_value(defaults.mix.proposals),
+                  "Relative frequency of proposals and approvals")
+            ("account-update-weight", bpo::value<uint32_t>()->default_value(defaults.mix.account_updates),
+                  "Relative frequency of account updates")
+            ("htlc-weight", bpo::value<uint32_t>()->default_value(defaults.mix.htlcs),
+                  "Relative frequency of HTLC creations and redemptions")
+            ;
+
+      bpo::variables_map options;
+      try
+      {
+         boost::program_options::store( boost::program_options::parse_command_line(argc, argv, cli_options), options );
+      }
+      catch (const boost::program_options::error& e)
+      {
+         std::cerr << "workload_blocks:  error parsing command line: " << e.what() << "\n";
+         return 1;
+      }
+
+      if( options.count("help") )
+      {
+         std::cout << cli_options << "\n";
+         return 0;
+      }
+
+      fc::path data_dir = options["data-dir"].as<boost::filesystem::path>();
+      if( data_dir.is_relative() )
+         data_dir = fc::current_path() / data_dir;
+
+      workload_options workload;
+      workload.account_count = options["accounts"].as<uint32_t>();
+      workload.asset_count = options["assets"].as<uint32_t>();
+      workload.feed_producer_count = options["feed-producers"].as<uint32_t>();
+      workload.transactions_per_block = options["tx-per-block"].as<uint32_t>();
+      workload.zipf_exponent = options["zipf-exponent"].as<double>();
+      workload.seed = options["seed"].as<uint64_t>();
+      workload.genesis_time = fc::time_point_sec( options["genesis-time"].as<uint32_t>() );
+      workload.maintenance_interval = options["maintenance-interval"].as<uint32_t>();
+      workload.mix.transfers = options["transfer-weight"].as<uint32_t>();
+      workload.mix.limit_orders = options["limit-order-weight"].as<uint32_t>();
+      workload.mix.price_feeds = options["feed-weight"].as<uint32_t>();
+      workload.mix.proposals = options["proposal-weight"].as<uint32_t>();
+      workload.mix.account_updates = options["account-update-weight"].as<uint32_t>();
+      workload.mix.htlcs = options["htlc-weight"].as<uint32_t>();
+
+      workload_generator generator( workload );
+      const uint32_t num_blocks = options["num-blocks"].as<uint32_t>();
+
+      // an existing database is extended with more workload blocks, its genesis state is kept and the
+      // generator continues from the state saved by the previous run
+      fc::path genesis_path = data_dir / "genesis.json";
+      fc::path state_path = data_dir / "generator_state.json";
+      genesis_state_type genesis = generator.genesis();
+      if( fc::exists( genesis_path ) )
+         genesis = fc::json::from_file( genesis_path ).as< genesis_state_type >( 20 );
+      else
+      {
+         fc::create_directories( data_dir );
+         fc::json::save_to_file( genesis, genesis_path );
+      }
+      std::cerr << "workload_blocks:  Genesis timestamp is " << genesis.initial_timestamp.sec_since_epoch() << "\n";
+
+      database db;
+      db.open( data_dir / "db", [&genesis]() { return genesis; }, "WORKLOAD" );
+
+      if( db.head_block_num() == 0 )
+      {
+         uint32_t setup_blocks = generator.generate_setup_blocks( db );
+         std::cerr << "workload_blocks:  Generated " << setup_blocks << " setup blocks\n";
+      }
+      else
+      {
+         FC_ASSERT( fc::exists( state_path ), "The generator state of the existing database is missing" );
+         generator.load_state( db, state_path );
+      }
+
+      for( uint32_t i = 1; i <= num_blocks; ++i )
+      {
+         generator.generate_block( db );
+         if( (i % 1000) == 0 )
+            std::cerr << "\rblock #" << db.head_block_num() << "   operations " << generator.operation_count()
+                      << "   rejected transactions " << generator.rejected_transaction_count();
+      }
+      std::cerr << "\nworkload_blocks:  Head block is #" << db.head_block_num() << " with "
+                << generator.operation_count() << " operations generated, "
+                << generator.rejected_transaction_count() << " transactions rejected\n";
+      generator.save_state( db, state_path );
+      db.close();
+   }
+   catch ( const fc::exception& e )
+   {
+      std::cout << e.to_detail_string() << "\n";
+      return 1;
+   }
+   return 0;
+}
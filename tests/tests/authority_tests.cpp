@@ -2183,6 +2183,172 @@ BOOST_AUTO_TEST_CASE( irrelevant_signatures )
    PUSH_TX( db, trx );
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( authority_cache_test )
+{ try {
+   ACTORS( (alice)(bob) );
+   fund( alice );
+
+   const fc::ecc::private_key key1 = fc::ecc::private_key::regenerate( fc::digest( "key1" ) );
+   const fc::ecc::private_key key2 = fc::ecc::private_key::regenerate( fc::digest( "key2" ) );
+   const fc::ecc::private_key key3 = fc::ecc::private_key::regenerate( fc::digest( "key3" ) );
+   const public_key_type key1_pub( key1.get_public_key() );
+   const public_key_type key2_pub( key2.get_public_key() );
+   const public_key_type key3_pub( key3.get_public_key() );
+
+   account_update_operation auo;
+   auo.account = alice_id;
+   auo.active = authority( 2, key1_pub, 1, key2_pub, 1 );
+   trx.operations.push_back( auo );
+   sign( trx, alice_private_key );
+   PUSH_TX( db, trx );
+   trx.clear();
+
+   const authority_cache& cache = db.get_authority_cache();
+   auto transfer = [&]( int64_t amount, const vector<fc::ecc::private_key>& keys ) {
+      transfer_operation to;
+      to.amount = asset( amount );
+      to.from = alice_id;
+      to.to = bob_id;
+      trx.clear();
+      trx.operations.push_back( to );
+      for( const auto& key : keys )
+         sign( trx, key );
+      PUSH_TX( db, trx );
+   };
+
+   // the first check computes the outcome, the second one reuses it
+   uint64_t hits = cache.hits();
+   uint64_t misses = cache.misses();
+   transfer( 1, { key1, key2 } );
+   BOOST_CHECK_EQUAL( cache.misses(), misses + 1 );
+   BOOST_CHECK_EQUAL( cache.hits(), hits );
+   transfer( 2, { key1, key2 } );
+   BOOST_CHECK_EQUAL( cache.misses(), misses + 1 );
+   BOOST_CHECK_EQUAL( cache.hits(), hits + 1 );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 3 );
+
+   // a cached outcome still reports irrelevant and insufficient signatures
+   GRAPHENE_REQUIRE_THROW( transfer( 3, { key1, key2, key3 } ), tx_irrelevant_sig );
+   GRAPHENE_REQUIRE_THROW( transfer( 3, { key1, key2, key3 } ), tx_irrelevant_sig );
+   GRAPHENE_REQUIRE_THROW( transfer( 3, { key1 } ), tx_missing_active_auth );
+   GRAPHENE_REQUIRE_THROW( transfer( 3, { key1 } ), tx_missing_active_auth );
+
+   // changing the authority invalidates the outcomes computed with the old one
+   auo.active = authority( 1, key3_pub, 1 );
+   trx.clear();
+   trx.operations.push_back( auo );
+   sign( trx, key1 );
+   sign( trx, key2 );
+   PUSH_TX( db, trx );
+
+   GRAPHENE_REQUIRE_THROW( transfer( 4, { key1, key2 } ), tx_missing_active_auth );
+   transfer( 5, { key3 } );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 8 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( authority_cache_shared_key_test )
+{ try {
+   ACTORS( (alice)(bob)(carol) );
+   fund( alice );
+   fund( bob );
+
+   // alice and bob share their only active key
+   const fc::ecc::private_key shared = fc::ecc::private_key::regenerate( fc::digest( "shared" ) );
+   const public_key_type shared_pub( shared.get_public_key() );
+   db.modify( alice, [&]( account_object& a ) {
+      a.active = authority( 1, shared_pub, 1 );
+   });
+   db.modify( bob, [&]( account_object& a ) {
+      a.active = authority( 1, shared_pub, 1 );
+   });
+
+   auto add_transfer = [&]( account_id_type from, int64_t amount ) {
+      transfer_operation to;
+      to.amount = asset( amount );
+      to.from = from;
+      to.to = carol_id;
+      trx.operations.push_back( to );
+   };
+
+   // the check of alice marks the key as used before bob is checked, bob's outcome is cached afterwards
+   const authority_cache& cache = db.get_authority_cache();
+   const uint64_t misses = cache.misses();
+   add_transfer( alice_id, 1 );
+   add_transfer( bob_id, 2 );
+   sign( trx, shared );
+   PUSH_TX( db, trx );
+   trx.clear();
+   BOOST_CHECK_EQUAL( cache.misses(), misses + 2 );
+
+   // reusing bob's outcome alone still finds the key used
+   const uint64_t hits = cache.hits();
+   add_transfer( bob_id, 4 );
+   sign( trx, shared );
+   PUSH_TX( db, trx );
+   trx.clear();
+   BOOST_CHECK_EQUAL( cache.hits(), hits + 1 );
+   BOOST_CHECK_EQUAL( get_balance( carol_id, asset_id_type() ), 7 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( proposal_authorization_outcomes )
+{ try {
+   ACTORS( (alice)(bob)(carol)(dave) );
+   fund( alice );
+
+   // alice needs both bob and carol
+   db.modify( alice, [&]( account_object& a ) {
+      a.active = authority( 2, bob_id, 1, carol_id, 1 );
+   });
+
+   transfer_operation top;
+   top.from = alice_id;
+   top.to = dave_id;
+   top.amount = asset( 100 );
+   proposal_create_operation pop;
+   pop.proposed_ops.emplace_back( top );
+   pop.fee_paying_account = dave_id;
+   pop.expiration_time = db.head_block_time() + fc::days(1);
+   trx.operations.push_back( pop );
+   sign( trx, dave_private_key );
+   const proposal_id_type pid = PUSH_TX( db, trx ).operation_results[0].get<object_id_type>();
+   trx.clear();
+
+   auto approve = [&]( account_id_type account, bool add ) {
+      db.modify( pid(db), [account,add]( proposal_object& p ) {
+         if( add )
+            p.available_active_approvals.insert( account );
+         else
+            p.available_active_approvals.erase( account );
+      });
+   };
+
+   BOOST_CHECK( !pid(db).is_authorized_to_execute( db ) );
+   approve( bob_id, true );
+   BOOST_CHECK( !pid(db).is_authorized_to_execute( db ) );
+   // dave plays no role in the authority of alice
+   approve( dave_id, true );
+   BOOST_CHECK( !pid(db).is_authorized_to_execute( db ) );
+   approve( carol_id, true );
+   BOOST_CHECK( pid(db).is_authorized_to_execute( db ) );
+   approve( dave_id, false );
+   BOOST_CHECK( pid(db).is_authorized_to_execute( db ) );
+   approve( carol_id, false );
+   BOOST_CHECK( !pid(db).is_authorized_to_execute( db ) );
+
+   // a change of the authority is noticed although the approvals did not change
+   db.modify( alice, []( account_object& a ) {
+      a.active.weight_threshold = 1;
+   });
+   BOOST_CHECK( pid(db).is_authorized_to_execute( db ) );
+
+   // an unnecessary key approval makes the proposal unauthorized
+   db.modify( pid(db), []( proposal_object& p ) {
+      p.available_key_approvals.insert( public_key_type( fc::ecc::private_key::regenerate(
+                                                            fc::digest( "unused" ) ).get_public_key() ) );
+   });
+   BOOST_CHECK( !pid(db).is_authorized_to_execute( db ) );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( self_approving_proposal )
 { try {
    ACTORS( (alice) );
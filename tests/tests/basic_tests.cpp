@@ -32,6 +32,10 @@
 
 #include <graphene/db/simple_index.hpp>
 
+#include <graphene/protocol/pack_stream.hpp>
+#include <graphene/protocol/sha256_batch.hpp>
+#include <graphene/protocol/signature_cache.hpp>
+
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/hex.hpp>
 #include "../common/database_fixture.hpp"
@@ -592,6 +596,124 @@ BOOST_AUTO_TEST_CASE( merkle_root )
    BOOST_CHECK( block.calculate_merkle_root() == c(dO) );
 }
 
+/**
+ * Verify that cached signature recovery returns the same keys as uncached recovery,
+ * and that the cache stays within its capacity
+ */
+BOOST_AUTO_TEST_CASE( signature_cache_test )
+{
+   signature_cache cache( 32 );
+   const fc::ecc::private_key key = fc::ecc::private_key::regenerate( fc::sha256::hash( string( "sig_cache" ) ) );
+
+   vector< digest_type > digests;
+   for( int i = 0; i < 64; ++i )
+      digests.push_back( digest_type::hash( std::to_string( i ) ) );
+
+   for( const digest_type& d : digests )
+   {
+      const signature_type sig = key.sign_compact( d );
+      BOOST_CHECK( cache.recover( d, sig ) == public_key_type( fc::ecc::public_key( sig, d ) ) );
+      BOOST_CHECK( cache.recover( d, sig ) == public_key_type( key.get_public_key() ) );
+   }
+   BOOST_CHECK_EQUAL( cache.misses(), 64u );
+   BOOST_CHECK_EQUAL( cache.hits(), 64u );
+   BOOST_CHECK_LE( cache.size(), 32u );
+
+   cache.set_capacity( 0 );
+   BOOST_CHECK_EQUAL( cache.size(), 0u );
+   const signature_type sig = key.sign_compact( digests[0] );
+   cache.recover( digests[0], sig );
+   cache.recover( digests[0], sig );
+   BOOST_CHECK_EQUAL( cache.misses(), 66u );
+   BOOST_CHECK_EQUAL( cache.size(), 0u );
+}
+
+/**
+ * Verify that every SHA-256 kernel supported by this machine produces the same digests as fc::sha256
+ */
+BOOST_AUTO_TEST_CASE( sha256_batch_test )
+{
+   std::mt19937 rng( 1 );
+   vector< string > data;
+   // cover empty messages, messages whose padding needs a second block and multiple blocks
+   for( size_t size : { 0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000 } )
+      data.push_back( string( size, 'x' ) );
+   for( int i = 0; i < 50; ++i )
+   {
+      string s( rng() % 300, 0 );
+      for( char& c : s )
+         c = char( rng() );
+      data.push_back( s );
+   }
+
+   vector< sha256_message > messages;
+   vector< fc::sha256 > expected;
+   for( const string& s : data )
+   {
+      messages.push_back( { s.data(), s.size() } );
+      expected.push_back( fc::sha256::hash( s.data(), s.size() ) );
+   }
+
+   for( sha256_kernel kernel : { sha256_kernel::scalar, sha256_kernel::avx2, sha256_kernel::sha_ni } )
+   {
+      if( !sha256_kernel_supported( kernel ) )
+         continue;
+      BOOST_TEST_MESSAGE( "Testing SHA-256 kernel " + std::to_string( int( kernel ) ) );
+      // also cover batches smaller than the number of lanes
+      for( size_t count : { size_t(1), size_t(3), messages.size() } )
+      {
+         vector< fc::sha256 > results( count );
+         sha256_batch( messages.data(), count, results.data(), kernel );
+         for( size_t i = 0; i < count; ++i )
+            BOOST_CHECK( results[i] == expected[i] );
+      }
+   }
+}
+
+/**
+ * Verify that packing into the reused buffer and into several digests at once matches plain packing,
+ * and that precomputable transactions derive the same id, size and signature keys from one packing
+ */
+BOOST_AUTO_TEST_CASE( pack_stream_test )
+{ try {
+   const auto key = fc::ecc::private_key::regenerate( fc::sha256::hash( std::string("pack_stream_test") ) );
+   signed_transaction tx;
+   transfer_operation op;
+   op.amount = asset( 12345 );
+   op.memo = memo_data();
+   op.memo->message.resize( 300 );
+   tx.operations.push_back( op );
+   tx.operations.push_back( op );
+   tx.expiration = fc::time_point_sec( 1000000 );
+   tx.sign( key, db.get_chain_id() );
+
+   vector<char>& packed = thread_pack_buffer();
+   vector_stream stream( packed );
+   fc::raw::pack( stream, tx );
+   BOOST_CHECK( packed == fc::raw::pack( tx ) );
+
+   digest_type::encoder first;
+   digest_type::encoder second;
+   fc::raw::pack( second, db.get_chain_id() );
+   digest_stream<digest_type::encoder, 3> digests( {{ &first, nullptr, &second }} );
+   fc::raw::pack( digests, static_cast<const transaction&>( tx ) );
+   BOOST_CHECK_EQUAL( digests.size(), fc::raw::pack_size( static_cast<const transaction&>( tx ) ) );
+   BOOST_CHECK( first.result() == tx.digest() );
+
+   // a precomputable transaction derives its id, packed size and signature keys from a single packing
+   precomputable_transaction ptx( tx );
+   BOOST_CHECK( ptx.get_signature_keys( db.get_chain_id() ) == tx.get_signature_keys( db.get_chain_id() ) );
+   BOOST_CHECK_EQUAL( ptx.get_signature_keys( db.get_chain_id() ).size(), 1u );
+   BOOST_CHECK( ptx.id() == signed_transaction( tx ).id() );
+   BOOST_CHECK_EQUAL( ptx.get_packed_size(), tx.get_packed_size() );
+
+   precomputable_transaction ptx2( tx );
+   const precomputable_transaction* trxs[] = { &ptx2 };
+   precomputable_transaction::precompute_ids( trxs, 1 );
+   BOOST_CHECK( ptx2.id() == ptx.id() );
+   BOOST_CHECK_EQUAL( ptx2.get_packed_size(), tx.get_packed_size() );
+} FC_LOG_AND_RETHROW() }
+
 /**
  * Reproduces https://github.com/bitshares/bitshares-core/issues/888 and tests fix for it.
  */
@@ -39,6 +39,7 @@
 #include <graphene/utilities/tempdir.hpp>
 
 #include <fc/crypto/digest.hpp>
+#include <fc/io/raw.hpp>
 
 #include "../common/database_fixture.hpp"
 
@@ -129,6 +130,57 @@ BOOST_AUTO_TEST_CASE( block_database_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( signed_block_view_test )
+{
+   try {
+      fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+      block_database bdb;
+      bdb.open( data_dir.path() );
+
+      signed_block b;
+      b.witness = witness_id_type(1);
+      for( uint32_t i = 0; i < 5; ++i )
+      {
+         transfer_operation op;
+         op.from = account_id_type(i);
+         op.amount = asset( i + 1 );
+         processed_transaction trx;
+         trx.operations.push_back( op );
+         trx.expiration = fc::time_point_sec( 1000 + i );
+         trx.operation_results.push_back( void_result() );
+         b.transactions.push_back( trx );
+      }
+      b.transaction_merkle_root = b.calculate_merkle_root();
+      bdb.store( b.id(), b );
+
+      auto view = bdb.fetch_view_by_number( b.block_num() );
+      BOOST_REQUIRE( view.valid() );
+      BOOST_CHECK( view->id() == b.id() );
+      BOOST_CHECK( view->header().witness == b.witness );
+      BOOST_CHECK( view->header().transaction_merkle_root == b.transaction_merkle_root );
+      BOOST_CHECK( view->packed() == fc::raw::pack( b ) );
+      BOOST_REQUIRE_EQUAL( view->transaction_count(), 5u );
+
+      // access out of order, so that offsets are both found and reused
+      for( uint32_t i : { 3, 1, 4, 0, 2 } )
+         BOOST_CHECK( fc::raw::pack( view->transaction( i ) ) == fc::raw::pack( b.transactions[i] ) );
+      GRAPHENE_CHECK_THROW( view->transaction( 5 ), fc::exception );
+      BOOST_CHECK( fc::raw::pack( view->block() ) == fc::raw::pack( b ) );
+
+      view = bdb.fetch_view_optional( b.id() );
+      BOOST_REQUIRE( view.valid() );
+      BOOST_CHECK( view->transaction( 4 ).expiration == fc::time_point_sec( 1004 ) );
+      BOOST_CHECK( !bdb.fetch_view_optional( block_id_type() ).valid() );
+      BOOST_CHECK( !bdb.fetch_view_by_number( 2 ).valid() );
+
+      const signed_block_view empty_view( signed_block{} );
+      BOOST_CHECK_EQUAL( empty_view.transaction_count(), 0u );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( generate_empty_blocks )
 {
    try {
@@ -473,6 +525,134 @@ BOOST_AUTO_TEST_CASE( fork_blocks )
 }
 
 
+BOOST_AUTO_TEST_CASE( switch_back_to_validated_fork )
+{
+   try {
+      fc::temp_directory data_dir1( graphene::utilities::temp_directory_path() );
+      fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+      fc::temp_directory data_dir3( graphene::utilities::temp_directory_path() );
+
+      database db1;
+      db1.open(data_dir1.path(), make_genesis, "TEST");
+      database db2;
+      db2.open(data_dir2.path(), make_genesis, "TEST");
+      database db3;
+      db3.open(data_dir3.path(), make_genesis, "TEST");
+
+      auto init_account_priv_key  = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
+
+      for( uint32_t i = 1; i <= 5; ++i )
+      {
+         auto b = db1.generate_block(db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+         PUSH_BLOCK( db2, b );
+         PUSH_BLOCK( db3, b );
+      }
+
+      // fork A: 2 blocks applied by db1 and db3
+      for( uint32_t i = 6; i <= 7; ++i )
+      {
+         auto b = db1.generate_block(db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+         PUSH_BLOCK( db3, b );
+      }
+      const block_id_type fork_a_tip = db1.head_block_id();
+
+      // fork B: 3 blocks, db1 switches to it
+      uint32_t next_slot = 3;
+      for( uint32_t i = 6; i <= 8; ++i )
+      {
+         auto b = db2.generate_block(db2.get_slot_time(next_slot), db2.get_scheduled_witness(next_slot), init_account_priv_key, database::skip_nothing);
+         next_slot = 1;
+         PUSH_BLOCK( db1, b );
+      }
+      BOOST_CHECK( db1.head_block_id() == db2.head_block_id() );
+      BOOST_CHECK( db1.fetch_block_by_id( fork_a_tip ).valid() );
+
+      const auto fork_a_item = db1.get_fork_database().fetch_block( fork_a_tip );
+      BOOST_REQUIRE( fork_a_item );
+      BOOST_REQUIRE( fork_a_item->applied_skip_flags.valid() );
+      BOOST_CHECK( !( *fork_a_item->applied_skip_flags & database::skip_merkle_check ) );
+      // the merkle root was checked when the block was applied, so a bad one must go unnoticed when applying it again
+      fork_a_item->data.transaction_merkle_root = checksum_type::hash( string("tampered") );
+
+      // fork A grows longer, db1 switches back, applying the blocks it validated before again
+      for( uint32_t i = 8; i <= 9; ++i )
+      {
+         auto b = db3.generate_block(db3.get_slot_time(1), db3.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+         PUSH_BLOCK( db1, b );
+      }
+      BOOST_CHECK_EQUAL( db1.head_block_num(), 9u );
+      BOOST_CHECK( db1.head_block_id() == db3.head_block_id() );
+      BOOST_CHECK( db1.get_dynamic_global_properties().current_witness
+                   == db3.get_dynamic_global_properties().current_witness );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( switch_back_to_fork_applied_with_skips )
+{
+   try {
+      fc::temp_directory data_dir1( graphene::utilities::temp_directory_path() );
+      fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+      fc::temp_directory data_dir3( graphene::utilities::temp_directory_path() );
+
+      database db1;
+      db1.open(data_dir1.path(), make_genesis, "TEST");
+      database db2;
+      db2.open(data_dir2.path(), make_genesis, "TEST");
+      database db3;
+      db3.open(data_dir3.path(), make_genesis, "TEST");
+
+      auto init_account_priv_key  = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
+      const uint32_t skips = database::skip_witness_signature | database::skip_merkle_check
+                             | database::skip_block_size_check;
+
+      for( uint32_t i = 1; i <= 5; ++i )
+      {
+         auto b = db1.generate_block(db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+         PUSH_BLOCK( db2, b );
+         PUSH_BLOCK( db3, b );
+      }
+
+      // fork A: 2 blocks applied by db1 with some checks skipped
+      vector<block_id_type> fork_a;
+      for( uint32_t i = 6; i <= 7; ++i )
+      {
+         auto b = db3.generate_block(db3.get_slot_time(1), db3.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+         PUSH_BLOCK( db1, b, skips );
+         fork_a.push_back( b.id() );
+      }
+      for( const auto& id : fork_a )
+      {
+         const auto item = db1.get_fork_database().fetch_block( id );
+         BOOST_REQUIRE( item && item->applied_skip_flags.valid() );
+         BOOST_CHECK_EQUAL( *item->applied_skip_flags, skips );
+      }
+
+      // fork B: 3 blocks, db1 switches to it
+      uint32_t next_slot = 3;
+      for( uint32_t i = 6; i <= 8; ++i )
+      {
+         auto b = db2.generate_block(db2.get_slot_time(next_slot), db2.get_scheduled_witness(next_slot), init_account_priv_key, database::skip_nothing);
+         next_slot = 1;
+         PUSH_BLOCK( db1, b );
+      }
+      BOOST_CHECK( db1.head_block_id() == db2.head_block_id() );
+
+      // fork A grows longer, db1 switches back and does the checks it skipped before
+      for( uint32_t i = 8; i <= 9; ++i )
+      {
+         auto b = db3.generate_block(db3.get_slot_time(1), db3.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing);
+         PUSH_BLOCK( db1, b );
+      }
+      BOOST_CHECK( db1.head_block_id() == db3.head_block_id() );
+      for( const auto& id : fork_a )
+      {
+         const auto item = db1.get_fork_database().fetch_block( id );
+         BOOST_REQUIRE( item && item->applied_skip_flags.valid() );
+         BOOST_CHECK_EQUAL( *item->applied_skip_flags, (uint32_t)database::skip_nothing );
+      }
+   } FC_LOG_AND_RETHROW()
+}
+
 /**
  *  These test has been disabled, out of order blocks should result in the node getting disconnected.
  *  
@@ -500,6 +680,7 @@ BOOST_AUTO_TEST_CASE( fork_db_tests )
      FC_ASSERT( head && head->data.block_num() == 2001, "", ("head",head->data.block_num()) );
   } FC_LOG_AND_RETHROW() 
 }
+
 BOOST_AUTO_TEST_CASE( out_of_order_blocks )
 {
    try {
@@ -618,6 +799,108 @@ BOOST_AUTO_TEST_CASE( undo_pending )
    }
 }
 
+BOOST_AUTO_TEST_CASE( generate_block_from_pending_state )
+{
+   try {
+      fc::temp_directory dir1( graphene::utilities::temp_directory_path() ),
+                         dir2( graphene::utilities::temp_directory_path() );
+      database db1,
+               db2;
+      db1.open(dir1.path(), make_genesis, "TEST");
+      db2.open(dir2.path(), make_genesis, "TEST");
+
+      auto init_account_priv_key  = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
+
+      // the number of transfers a database evaluated since the last call
+      auto transfers_evaluated = []( database& db ) -> uint64_t {
+         uint64_t count = 0;
+         for( const operation_profile& profile : db.get_operation_profiler().get_profile() )
+            if( profile.operation == "transfer_operation" )
+               count = profile.count;
+         db.get_operation_profiler().reset();
+         return count;
+      };
+      auto push_transfers = []( database& db, uint32_t count, int64_t first_amount ) {
+         for( uint32_t i = 0; i < count; ++i )
+         {
+            signed_transaction trx;
+            set_expiration( db, trx );
+            transfer_operation t;
+            t.to = account_id_type(1);
+            t.amount = asset( first_amount + i );
+            trx.operations.push_back( t );
+            PUSH_TX( db, trx, ~0 );
+         }
+      };
+      auto generate = [&init_account_priv_key]( database& db, uint32_t skip ) {
+         return db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, skip );
+      };
+      db1.get_operation_profiler().enable( true );
+      db2.get_operation_profiler().enable( true );
+
+      BOOST_TEST_MESSAGE( "Comparing a block reusing the pending state with a block built from scratch" );
+      push_transfers( db1, 5, 100 );
+      push_transfers( db2, 5, 100 );
+      transfers_evaluated( db1 );
+      transfers_evaluated( db2 );
+      const signed_block reused = generate( db1, ~0 );
+      // the transactions were pushed skipping the TaPoS check, which db2 does not skip now, so it applies them again
+      const signed_block rebuilt = generate( db2, ~0 & ~database::skip_tapos_check );
+      BOOST_CHECK_EQUAL( transfers_evaluated( db1 ), 5u ); // only when applying the block
+      BOOST_CHECK_EQUAL( transfers_evaluated( db2 ), 10u );
+      BOOST_CHECK_EQUAL( reused.transactions.size(), 5u );
+      BOOST_CHECK( fc::raw::pack( reused ) == fc::raw::pack( rebuilt ) );
+      BOOST_CHECK( db1.head_block_id() == db2.head_block_id() );
+      BOOST_CHECK( db1.get_balance( account_id_type(1), asset_id_type() )
+                   == db2.get_balance( account_id_type(1), asset_id_type() ) );
+
+      BOOST_TEST_MESSAGE( "Rebuilding the pending state after it was rewound by popping a block" );
+      push_transfers( db1, 2, 200 );
+      const signed_block popped = generate( db1, ~0 );
+      push_transfers( db1, 3, 300 );
+      db1.pop_block();
+      transfers_evaluated( db1 );
+      const signed_block after_pop = generate( db1, ~0 );
+      BOOST_REQUIRE_EQUAL( after_pop.transactions.size(), 3u );
+      for( uint32_t i = 0; i < 3; ++i )
+         BOOST_CHECK_EQUAL( after_pop.transactions[i].operations[0].get<transfer_operation>().amount.amount.value,
+                            300 + i );
+      // applied again for the block, applied by the block, and the popped transactions pushed again
+      BOOST_CHECK_EQUAL( transfers_evaluated( db1 ), 3u + 3u + 2u );
+      const signed_block after_popped = generate( db1, ~0 );
+      BOOST_REQUIRE_EQUAL( after_popped.transactions.size(), 2u );
+      BOOST_CHECK( after_popped.transactions[0].id() == popped.transactions[0].id() );
+      BOOST_CHECK( after_popped.transactions[1].id() == popped.transactions[1].id() );
+
+      BOOST_TEST_MESSAGE( "Postponing the transactions which do not fit into a block" );
+      signed_transaction sample;
+      set_expiration( db1, sample );
+      sample.operations.push_back( transfer_operation() );
+      const uint32_t max_block_size = fc::raw::pack_size( signed_block_header() ) + 4 * fc::raw::pack_size( sample );
+      db1.modify( db1.get_global_properties(), [max_block_size]( global_property_object& p ) {
+         p.parameters.maximum_block_size = max_block_size;
+      });
+      push_transfers( db1, 10, 400 );
+      transfers_evaluated( db1 );
+      const signed_block partial = generate( db1, ~0 );
+      BOOST_CHECK_GT( partial.transactions.size(), 0u );
+      BOOST_CHECK_LT( partial.transactions.size(), 10u );
+      BOOST_CHECK_LE( fc::raw::pack_size( partial ), max_block_size );
+      BOOST_CHECK_GT( transfers_evaluated( db1 ), partial.transactions.size() );
+      size_t included = partial.transactions.size();
+      while( included < 10 )
+      {
+         const signed_block next = generate( db1, ~0 );
+         BOOST_REQUIRE( !next.transactions.empty() );
+         included += next.transactions.size();
+      }
+      BOOST_CHECK_EQUAL( included, 10u );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( switch_forks_undo_create )
 {
    try {
@@ -1094,6 +1377,64 @@ BOOST_FIXTURE_TEST_CASE( pop_block_twice, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( witness_schedule_table, database_fixture )
+{ try {
+   // the precomputed schedule must answer like the objects it was built from
+   auto check_schedule_table = [this]()
+   {
+      const auto table = db.get_witness_schedule_table();
+      BOOST_CHECK( table->head_block_id == db.head_block_id() );
+      const dynamic_global_property_object& dpo = db.get_dynamic_global_properties();
+      const auto& witnesses = witness_schedule_id_type()(db).current_shuffled_witnesses;
+      BOOST_REQUIRE_EQUAL( table->slots.size(), witnesses.size() );
+      const uint32_t skip_slots = ( dpo.dynamic_flags & dynamic_global_property_object::maintenance_flag ) ?
+                                  db.get_global_properties().parameters.maintenance_skip_slots : 0;
+      BOOST_CHECK_EQUAL( table->get_slot_at_time( db.head_block_time() ), 0u );
+      for( uint32_t slot = 0; slot <= 2 * witnesses.size(); ++slot )
+      {
+         BOOST_CHECK( table->get_scheduled_witness( slot ) == witnesses[ ( dpo.current_aslot + slot ) % witnesses.size() ] );
+         BOOST_CHECK( table->get_scheduled_signing_key( slot ) == table->get_scheduled_witness( slot )(db).signing_key );
+         if( slot == 0 )
+            continue;
+         const fc::time_point_sec slot_time = db.head_block_time() + ( slot + skip_slots ) * db.block_interval();
+         BOOST_CHECK( table->get_slot_time( slot ) == slot_time );
+         BOOST_CHECK_EQUAL( table->get_slot_at_time( slot_time ), slot );
+         BOOST_CHECK_EQUAL( table->get_slot_at_time( slot_time + 1 ), slot );
+      }
+   };
+
+   check_schedule_table();
+   const auto first_table = db.get_witness_schedule_table();
+   const block_id_type first_head = db.head_block_id();
+
+   generate_block();
+   check_schedule_table();
+   // a table held by a reader is not affected by later blocks
+   BOOST_CHECK( first_table->head_block_id == first_head );
+
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   BOOST_CHECK( db.get_dynamic_global_properties().dynamic_flags & dynamic_global_property_object::maintenance_flag );
+   check_schedule_table();
+
+   generate_block();
+   generate_block();
+   db.pop_block();
+   check_schedule_table();
+
+   // a block undone because a plugin failed leaves the table of that block behind
+   {
+      boost::signals2::scoped_connection connection = db.applied_block.connect( []( const signed_block& ) {
+         FC_THROW_EXCEPTION( plugin_exception, "failing plugin" );
+      } );
+      const block_id_type head = db.head_block_id();
+      GRAPHENE_REQUIRE_THROW( generate_block(), plugin_exception );
+      BOOST_REQUIRE( db.head_block_id() == head );
+   }
+   check_schedule_table();
+   generate_block();
+   check_schedule_table();
+} FC_LOG_AND_RETHROW() }
+
 BOOST_FIXTURE_TEST_CASE( rsf_missed_blocks, database_fixture )
 {
    try
@@ -1368,6 +1709,88 @@ BOOST_FIXTURE_TEST_CASE( transaction_invalidated_in_cache, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( pending_transactions_revalidated_after_authority_change, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+      transfer( account_id_type(), alice_id, asset( 10000 ) );
+      transfer( account_id_type(),   bob_id, asset( 10000 ) );
+      generate_block();
+
+      fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+
+      database db2;
+      db2.open(data_dir2.path(), make_genesis, "TEST");
+      BOOST_CHECK( db.get_chain_id() == db2.get_chain_id() );
+
+      while( db2.head_block_num() < db.head_block_num() )
+      {
+         optional< signed_block > b = db.fetch_block_by_number( db2.head_block_num()+1 );
+         db2.push_block(*b, database::skip_witness_signature
+                           |database::skip_transaction_signatures );
+      }
+
+      auto generate_xfer_tx = [&]( account_id_type from, account_id_type to, share_type amount,
+                                   const private_key_type& key ) -> signed_transaction
+      {
+         signed_transaction tx;
+         transfer_operation xfer_op;
+         xfer_op.from = from;
+         xfer_op.to = to;
+         xfer_op.amount = asset( amount, asset_id_type() );
+         xfer_op.fee = asset( 0, asset_id_type() );
+         tx.operations.push_back( xfer_op );
+         set_expiration( db, tx );
+         sign( tx, key );
+         return tx;
+      };
+
+      // both transfers wait in the pending queue of db
+      PUSH_TX( db, generate_xfer_tx( alice_id, bob_id, 1000, alice_private_key ), database::skip_nothing );
+      PUSH_TX( db, generate_xfer_tx( bob_id, alice_id, 300, bob_private_key ), database::skip_nothing );
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value, 9300 );
+      BOOST_CHECK_EQUAL( db.get_balance(   bob_id, asset_id_type() ).amount.value, 10700 );
+
+      // meanwhile alice replaces her keys in a block produced by another node
+      const private_key_type new_key = generate_private_key( "alice_new" );
+      account_update_operation uop;
+      uop.account = alice_id;
+      uop.owner = authority( 1, public_key_type( new_key.get_public_key() ), 1 );
+      uop.active = authority( 1, public_key_type( new_key.get_public_key() ), 1 );
+      signed_transaction update_tx;
+      update_tx.operations.push_back( uop );
+      set_expiration( db2, update_tx );
+      sign( update_tx, alice_private_key );
+      PUSH_TX( db2, update_tx, database::skip_nothing );
+
+      signed_block b = db2.generate_block( db2.get_slot_time(1), db2.get_scheduled_witness(1),
+                                           init_account_priv_key, database::skip_nothing );
+      PUSH_BLOCK( db, b, database::skip_nothing );
+
+      // alice's transfer is no longer authorized and has to be dropped,
+      // bob's transfer is untouched by the block and stays pending
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value, 10300 );
+      BOOST_CHECK_EQUAL( db.get_balance(   bob_id, asset_id_type() ).amount.value, 9700 );
+
+      // bob's authorities are not touched by the next block either, so his transfer is
+      // re-applied without looking them up again
+      const authority_cache& cache = db.get_authority_cache();
+      const uint64_t lookups = cache.hits() + cache.misses();
+      b = db2.generate_block( db2.get_slot_time(1), db2.get_scheduled_witness(1),
+                              init_account_priv_key, database::skip_nothing );
+      BOOST_REQUIRE( b.transactions.empty() );
+      PUSH_BLOCK( db, b, database::skip_nothing );
+      BOOST_CHECK_EQUAL( cache.hits() + cache.misses(), lookups );
+      BOOST_CHECK_EQUAL( db.get_balance(   bob_id, asset_id_type() ).amount.value, 9700 );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( genesis_reserve_ids )
 {
    try
@@ -35,6 +35,7 @@
 #include <graphene/db/simple_index.hpp>
 
 #include <fc/crypto/digest.hpp>
+#include <fc/io/raw.hpp>
 #include "../common/database_fixture.hpp"
 
 using namespace graphene::chain;
@@ -128,6 +129,90 @@ BOOST_AUTO_TEST_CASE( confidential_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( confidential_precompute_test )
+{ try {
+   ACTORS( (dan) )
+   const asset_object& core = asset_id_type()(db);
+
+   transfer(account_id_type()(db), dan, core.amount(1000000));
+   generate_block();
+
+   transfer_to_blind_operation to_blind;
+   to_blind.amount = core.amount(1000);
+   to_blind.from   = dan.id;
+
+   auto owner_pub = fc::ecc::private_key::generate().get_public_key();
+   auto B1     = fc::sha256::hash("B1");
+   auto B2     = fc::sha256::hash("B2");
+   auto nonce  = fc::sha256::hash("nonce");
+
+   blind_output out1, out2;
+   out1.owner = out2.owner = authority( 1, public_key_type(owner_pub), 1 );
+   out1.commitment  = fc::ecc::blind(B1,400);
+   out1.range_proof = fc::ecc::range_proof_sign( 0, out1.commitment, B1, nonce, 0, 0, 400 );
+   out2.commitment  = fc::ecc::blind(B2,600);
+   out2.range_proof = fc::ecc::range_proof_sign( 0, out2.commitment, B2, nonce, 0, 0, 600 );
+
+   to_blind.blinding_factor = fc::ecc::blind_sum( {B1,B2}, 2 );
+   to_blind.outputs = {out1,out2};
+   if( to_blind.outputs[1].commitment < to_blind.outputs[0].commitment )
+      std::swap( to_blind.outputs[0], to_blind.outputs[1] );
+
+   trx.operations = {to_blind};
+   set_expiration( db, trx );
+   sign( trx, dan_private_key );
+   PUSH_TX(db, trx);
+   trx.clear();
+
+   const signed_block block = generate_block();
+   BOOST_REQUIRE_EQUAL( block.transactions.size(), 1u );
+   db.pop_block();
+
+   const uint32_t replay_skip = database::skip_witness_signature | database::skip_transaction_signatures
+                                | database::skip_transaction_dupe_check | database::skip_tapos_check
+                                | database::skip_merkle_check | database::skip_witness_schedule_check;
+
+   // unpacked copies, so that nothing is cached on their transactions yet
+   const auto packed = fc::raw::pack( block );
+
+   BOOST_TEST_MESSAGE( "Splitting blocks into chunks for the worker threads" );
+   // the confidential transfer is handed to a worker thread even when all expensive checks are skipped
+   BOOST_CHECK( database::precompute_chunks( block, replay_skip, 4 ) == vector<size_t>{ 1 } );
+   BOOST_CHECK( database::precompute_chunks( block, replay_skip, 0 ) == vector<size_t>{ 1 } );
+   signed_block mixed;
+   mixed.transactions.push_back( block.transactions[0] );
+   for( int i = 0; i < 3; ++i )
+   {
+      signed_transaction plain;
+      plain.operations.push_back( transfer_operation() );
+      mixed.transactions.emplace_back( plain );
+   }
+   // the confidential transfer alone costs more than the three plain ones together
+   BOOST_CHECK( database::precompute_chunks( mixed, replay_skip, 2 ) == (vector<size_t>{ 1, 4 }) );
+   BOOST_CHECK( database::precompute_chunks( mixed, database::skip_nothing, 2 ) == (vector<size_t>{ 1, 4 }) );
+   // plain transfers are precomputed on the calling thread during a replay, and split evenly otherwise
+   mixed.transactions.erase( mixed.transactions.begin() );
+   BOOST_CHECK( database::precompute_chunks( mixed, replay_skip, 2 ).empty() );
+   BOOST_CHECK( database::precompute_chunks( mixed, database::skip_nothing, 2 ) == (vector<size_t>{ 2, 3 }) );
+
+   BOOST_TEST_MESSAGE( "Precomputing a block whose commitments do not add up, with all expensive checks skipped" );
+   signed_block broken = fc::raw::unpack<signed_block>( packed );
+   broken.transactions[0].operations[0].get<transfer_to_blind_operation>().blinding_factor = B1;
+   // validation happens in a worker, so the failure is reported by the future instead of the call itself
+   fc::future<void> precomputed;
+   BOOST_REQUIRE_NO_THROW( precomputed = db.precompute_parallel( broken, replay_skip ) );
+   BOOST_CHECK_THROW( precomputed.wait(), fc::exception );
+
+   BOOST_TEST_MESSAGE( "Precomputing and applying the intact block" );
+   signed_block intact = fc::raw::unpack<signed_block>( packed );
+   db.precompute_parallel( intact, replay_skip ).wait();
+   BOOST_CHECK( PUSH_BLOCK( db, intact, replay_skip ) == false );
+   BOOST_CHECK( db.head_block_id() == block.id() );
+   const auto fee = block.transactions[0].operations[0].get<transfer_to_blind_operation>().fee.amount.value;
+   BOOST_CHECK_EQUAL( get_balance( dan, core ), 1000000 - 1000 - fee );
+
+} FC_LOG_AND_RETHROW() }
+
 
 
 BOOST_AUTO_TEST_SUITE_END()
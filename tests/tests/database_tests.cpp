@@ -223,6 +223,229 @@ BOOST_AUTO_TEST_CASE( direct_index_test )
    // but the secondary has not updated its representation
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( object_change_set_test )
+{ try {
+   ACTORS((alice));
+   const asset_id_type usd_id = create_user_issued_asset( "USD" ).id;
+   fund( alice, asset(100000) );
+   generate_block();
+
+   optional<limit_order_id_type> order_id;
+   bool notified = false;
+   auto connection = db.object_changes.connect( [&]( const object_change_set& changes ) {
+      if( !order_id )
+         return;
+      notified = true;
+
+      const auto created = changes.ids( object_change::created, protocol_ids, limit_order_object_type );
+      BOOST_REQUIRE_EQUAL( created.second - created.first, 1 );
+      BOOST_CHECK( *created.first == object_id_type( *order_id ) );
+      BOOST_CHECK( changes.impacted_accounts( object_change::created ).count( alice_id ) );
+
+      // the ids of one type form the returned range
+      const auto& all_created = changes.ids( object_change::created );
+      BOOST_CHECK( std::is_sorted( all_created.begin(), all_created.end() ) );
+      for( auto itr = all_created.begin(); itr != all_created.end(); ++itr )
+         BOOST_CHECK( ( itr >= created.first && itr < created.second ) == itr->is<limit_order_id_type>() );
+
+      const auto none = changes.ids( object_change::removed, protocol_ids, limit_order_object_type );
+      BOOST_CHECK( none.first == none.second );
+      BOOST_CHECK( changes.impacted_accounts( object_change::modified ).count( alice_id ) );
+   } );
+
+   order_id = create_sell_order( alice_id, asset(1000), asset(1000, usd_id) )->id;
+   generate_block();
+   BOOST_CHECK( notified );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( state_hash_test )
+{ try {
+   ACTORS((alice)(bob));
+   fund( alice, asset(100000) );
+   generate_block();
+
+   db.enable_state_hash();
+
+   // the maintained digests always equal the ones computed by a full scan
+   auto check_state_hash = [this]() {
+      fc::uint128 total;
+      for( const auto& item : db.get_index_state_hashes() )
+      {
+         BOOST_CHECK( item.second == db.get_index( item.first.first, item.first.second ).hash() );
+         total += item.second;
+      }
+      BOOST_CHECK( total == db.get_state_hash() );
+   };
+   check_state_hash();
+   const fc::uint128 initial_hash = db.get_state_hash();
+
+   transfer( alice_id, bob_id, asset(1000) );
+   transfer( bob_id, alice_id, asset(300) );
+   check_state_hash();
+   BOOST_CHECK( initial_hash != db.get_state_hash() );
+
+   // undoing the changes restores the digest
+   db.clear_pending();
+   check_state_hash();
+   BOOST_CHECK( initial_hash == db.get_state_hash() );
+
+   transfer( alice_id, bob_id, asset(1000) );
+   generate_block();
+   check_state_hash();
+
+   db.pop_block();
+   check_state_hash();
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( account_member_index_test )
+{ try {
+   ACTORS( (alice)(bob)(charlie) );
+
+   const auto& members = dynamic_cast<const base_primary_index&>( db.get_index_type<account_index>() )
+                           .get_secondary_index<account_member_index>();
+   const public_key_type key( fc::ecc::private_key::regenerate( fc::digest( "member" ) ).get_public_key() );
+   auto referencing = [&members]( account_id_type member ) {
+      auto itr = members.account_to_account_memberships.find( member );
+      return itr == members.account_to_account_memberships.end() ? flat_set<account_id_type>() : itr->second;
+   };
+
+   db.modify( alice, [&]( account_object& a ) {
+      a.active = authority( 2, bob_id, 1, charlie_id, 1, key, 1 );
+   });
+   db.modify( bob, [&]( account_object& a ) {
+      a.owner = authority( 1, charlie_id, 1 );
+   });
+   BOOST_CHECK( referencing( bob_id ) == flat_set<account_id_type>{ alice_id } );
+   BOOST_CHECK( ( referencing( charlie_id ) == flat_set<account_id_type>{ alice_id, bob_id } ) );
+   BOOST_REQUIRE( members.account_to_key_memberships.find( key ) != members.account_to_key_memberships.end() );
+   BOOST_CHECK( members.account_to_key_memberships.find( key )->second == flat_set<account_id_type>{ alice_id } );
+
+   // only the difference is applied, keys which are no longer referenced stay known
+   db.modify( alice, [&]( account_object& a ) {
+      a.active = authority( 1, charlie_id, 1 );
+   });
+   BOOST_CHECK( referencing( bob_id ).empty() );
+   BOOST_CHECK( ( referencing( charlie_id ) == flat_set<account_id_type>{ alice_id, bob_id } ) );
+   BOOST_REQUIRE( members.account_to_key_memberships.find( key ) != members.account_to_key_memberships.end() );
+   BOOST_CHECK( members.account_to_key_memberships.find( key )->second.empty() );
+
+   // rebuilding from the accounts gives the same references
+   account_member_index rebuilt;
+   rebuilt.rebuild( db.get_index_type<account_index>() );
+   BOOST_CHECK( rebuilt.account_to_account_memberships.at( charlie_id ) == referencing( charlie_id ) );
+   BOOST_CHECK( rebuilt.account_to_key_memberships.find( key ) == rebuilt.account_to_key_memberships.end() );
+
+   // an account stays associated with a proposal while its approval is still required
+   const auto& approvals = db.get_index_type< primary_index< proposal_index > >()
+                             .get_secondary_index<required_approval_index>();
+   auto proposals = [&approvals]( account_id_type account ) {
+      auto itr = approvals._account_to_proposals.find( account );
+      return itr == approvals._account_to_proposals.end() ? flat_set<proposal_id_type>() : itr->second;
+   };
+   const proposal_object& proposal = db.create<proposal_object>( [&]( proposal_object& p ) {
+      p.expiration_time = db.head_block_time() + fc::days(1);
+      p.required_active_approvals = { alice_id };
+      p.available_active_approvals = { alice_id, bob_id };
+   });
+   const proposal_id_type proposal_id = proposal.id;
+   BOOST_CHECK( proposals( alice_id ) == flat_set<proposal_id_type>{ proposal_id } );
+   BOOST_CHECK( proposals( bob_id ) == flat_set<proposal_id_type>{ proposal_id } );
+   db.modify( proposal, []( proposal_object& p ) {
+      p.available_active_approvals.clear();
+   });
+   BOOST_CHECK( proposals( alice_id ) == flat_set<proposal_id_type>{ proposal_id } );
+   BOOST_CHECK( proposals( bob_id ).empty() );
+   db.remove( proposal );
+   BOOST_CHECK( approvals._account_to_proposals.find( alice_id ) == approvals._account_to_proposals.end() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( bulk_load_guard_test )
+{ try {
+   const auto& members = dynamic_cast<const base_primary_index&>( db.get_index_type<account_index>() )
+                           .get_secondary_index<account_member_index>();
+   const public_key_type key( fc::ecc::private_key::regenerate( fc::digest( "bulk" ) ).get_public_key() );
+
+   // bulk loading ends when an exception leaves the scope of the guard
+   try {
+      bulk_load_guard bulk_load( db );
+      FC_THROW( "Loading failed" );
+   } catch( const fc::exception& ) {
+   }
+
+   // otherwise bulk loading could not begin again
+   {
+      bulk_load_guard bulk_load( db );
+      bulk_load.end();
+      GRAPHENE_REQUIRE_THROW( bulk_load.end(), fc::exception );
+   }
+
+   // the secondary indexes are notified about changes again
+   const account_object& alice = create_account( "alice", key );
+   BOOST_REQUIRE( members.account_to_key_memberships.find( key ) != members.account_to_key_memberships.end() );
+   BOOST_CHECK( members.account_to_key_memberships.find( key )->second == flat_set<account_id_type>{ alice.id } );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( operation_profiler_test )
+{ try {
+   ACTORS( (alice)(bob) );
+   operation_profiler& profiler = db.get_operation_profiler();
+   BOOST_CHECK( !profiler.is_enabled() );
+
+   transfer( account_id_type(), alice_id, asset(10000) );
+   BOOST_CHECK( profiler.get_profile().empty() );
+
+   profiler.enable( true );
+   transfer( alice_id, bob_id, asset(100) );
+   transfer( alice_id, bob_id, asset(200) );
+   // a failing operation is validated and counted, but not timed
+   GRAPHENE_REQUIRE_THROW( transfer( bob_id, alice_id, asset(1000000) ), fc::exception );
+   trx.clear();
+   // a transaction which has been validated before is not validated again, so it is not timed either
+   {
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset(400);
+      trx.operations.push_back( op );
+      for( auto& o : trx.operations ) db.current_fee_schedule().set_fee( o );
+      set_expiration( db, trx );
+      precomputable_transaction validated_trx( trx );
+      validated_trx.validate();
+      db.push_transaction( validated_trx, ~0 );
+      trx.clear();
+   }
+   profiler.enable( false );
+   transfer( alice_id, bob_id, asset(300) );
+
+   vector<operation_profile> profile = profiler.get_profile();
+   BOOST_REQUIRE_EQUAL( profile.size(), 1u );
+   const operation_profile& transfers = profile.front();
+   BOOST_CHECK_EQUAL( transfers.operation, "transfer_operation" );
+   BOOST_CHECK_EQUAL( transfers.count, 3u );
+   BOOST_CHECK_EQUAL( transfers.failures, 1u );
+   BOOST_CHECK_GE( transfers.objects_created, 1u );
+   BOOST_CHECK_GE( transfers.objects_modified, 2u );
+   BOOST_REQUIRE_EQUAL( transfers.stages.size(), size_t( operation_profiler::stage_count ) );
+   BOOST_CHECK_EQUAL( transfers.stages[operation_profiler::validate_stage].stage, "validate" );
+   BOOST_CHECK_EQUAL( transfers.stages[operation_profiler::validate_stage].count, 3u );
+   for( int i = operation_profiler::fee_stage; i < operation_profiler::stage_count; ++i )
+   {
+      const operation_stage_profile& stage = transfers.stages[i];
+      BOOST_CHECK_EQUAL( stage.count, 3u );
+      BOOST_CHECK_LE( stage.p50_time, stage.p99_time );
+      BOOST_CHECK_LE( stage.p99_time, stage.max_time );
+      BOOST_CHECK_LE( stage.max_time, stage.total_time );
+   }
+   const auto& stages = transfers.stages;
+   BOOST_CHECK_GE( stages[operation_profiler::total_stage].total_time,
+                   stages[operation_profiler::fee_stage].total_time
+                   + stages[operation_profiler::evaluate_stage].total_time
+                   + stages[operation_profiler::apply_stage].total_time );
+
+   profiler.reset();
+   BOOST_CHECK( profiler.get_profile().empty() );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( required_approval_index_test ) // see https://github.com/bitshares/bitshares-core/issues/1719
 { try {
    ACTORS( (alice)(bob)(charlie)(agnetha)(benny)(carlos) );
@@ -714,6 +714,51 @@ BOOST_AUTO_TEST_CASE( account_create_fee_scaling )
    BOOST_CHECK_EQUAL(db.get_global_properties().parameters.get_current_fees().get<account_create_operation>().basic_fee, 1u);
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( fee_table_test )
+{ try {
+   db.modify(global_property_id_type()(db), [](global_property_object& gpo)
+   {
+      gpo.parameters.get_mutable_fees() = fee_schedule::get_default();
+      gpo.parameters.get_mutable_fees().get<transfer_operation>().fee = 100;
+      gpo.parameters.get_mutable_fees().get<transfer_operation>().price_per_kbyte = 1000;
+      gpo.parameters.get_mutable_fees().get<call_order_update_operation>().fee = 300;
+      // bid_collateral falls back to the fee of call_order_update
+      auto& params = gpo.parameters.get_mutable_fees().parameters;
+      params.erase( bid_collateral_operation::fee_parameters_type() );
+      gpo.parameters.get_mutable_fees().scale = GRAPHENE_100_PERCENT / 2;
+   });
+
+   transfer_operation transfer;
+   transfer.memo = memo_data();
+   transfer.memo->message.resize( 2000 );
+   operation op = transfer;
+   const fee_schedule& schedule = db.current_fee_schedule();
+   const share_type transfer_fee = schedule.calculate_fee( op ).amount;
+   BOOST_CHECK( db.current_fee_table().calculate_fee( op ) == schedule.calculate_fee( op ) );
+   BOOST_CHECK_GT( transfer_fee.value, ( 100 + 2000 ) / 2 );
+
+   operation bid = bid_collateral_operation();
+   BOOST_CHECK( db.current_fee_table().calculate_fee( bid ) == schedule.calculate_fee( bid ) );
+   BOOST_CHECK_EQUAL( db.current_fee_table().calculate_fee( bid ).amount.value, 150 );
+
+   const price rate = asset( 1 ) / asset( 3, asset_id_type(1) );
+   operation op2 = op;
+   BOOST_CHECK( db.current_fee_table().set_fee( op, rate ) == schedule.set_fee( op2, rate ) );
+   BOOST_CHECK( op.get<transfer_operation>().fee == op2.get<transfer_operation>().fee );
+
+   // the table follows changes of the global properties, and their undo
+   {
+      auto session = db._undo_db.start_undo_session();
+      db.modify(global_property_id_type()(db), [](global_property_object& gpo)
+      {
+         gpo.parameters.get_mutable_fees().get<transfer_operation>().fee = 500;
+      });
+      BOOST_CHECK_EQUAL( db.current_fee_table().calculate_fee( op ).amount.value, transfer_fee.value + 200 );
+   }
+   BOOST_CHECK_EQUAL( db.current_fee_table().calculate_fee( op ).amount.value, transfer_fee.value );
+   BOOST_CHECK_EQUAL( db.get_shared_fee_table()->get<transfer_operation>().fee, 100u );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( fee_refund_test )
 {
    try
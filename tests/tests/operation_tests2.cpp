@@ -2155,6 +2155,67 @@ BOOST_AUTO_TEST_CASE( top_n_special )
    } FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( top_n_special_unchanged )
+{
+   ACTORS( (alice)(izzy)(stan) );
+
+   generate_blocks( HARDFORK_516_TIME );
+
+   try
+   {
+      asset_id_type topn_id = create_user_issued_asset( "TOPN", izzy_id(db), 0 ).id;
+
+      {
+         top_holders_special_authority top1;
+         top1.num_top_holders = 1;
+         top1.asset = topn_id;
+
+         account_update_operation op;
+         op.account = stan_id;
+         op.extensions.value.active_special_authority = top1;
+         op.extensions.value.owner_special_authority = top1;
+
+         signed_transaction tx;
+         tx.operations.push_back( op );
+         set_expiration( db, tx );
+         sign( tx, stan_private_key );
+         PUSH_TX( db, tx );
+      }
+
+      set_expiration( db, trx );
+      issue_uia( alice_id, asset( 1000, topn_id ) );
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+
+      BOOST_CHECK( stan_id(db).owner  == authority(  501, alice_id, 1000 ) );
+      BOOST_CHECK( stan_id(db).active == authority(  501, alice_id, 1000 ) );
+
+      bool stan_changed = false;
+      boost::signals2::scoped_connection connection = db.changed_objects.connect(
+         [&stan_changed,stan_id]( const vector<object_id_type>& ids, const flat_set<account_id_type>& ) {
+            for( const object_id_type& id : ids )
+               if( id == object_id_type( stan_id ) )
+                  stan_changed = true;
+         } );
+
+      // the top holder did not change, so the maintenance leaves Stan alone
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+
+      BOOST_CHECK( !stan_changed );
+      BOOST_CHECK( stan_id(db).owner  == authority(  501, alice_id, 1000 ) );
+      BOOST_CHECK( stan_id(db).active == authority(  501, alice_id, 1000 ) );
+
+      // Izzy takes over
+      set_expiration( db, trx );
+      issue_uia( izzy_id, asset( 2000, topn_id ) );
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+
+      BOOST_CHECK( stan_changed );
+      BOOST_CHECK( stan_id(db).owner  == authority( 1001, izzy_id, 2000 ) );
+      BOOST_CHECK( stan_id(db).active == authority( 1001, izzy_id, 2000 ) );
+
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE( buyback )
 {
    ACTORS( (alice)(bob)(chloe)(dan)(izzy)(philbin) );
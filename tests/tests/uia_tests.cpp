@@ -342,6 +342,54 @@ BOOST_AUTO_TEST_CASE( transfer_whitelist_uia )
    }
 }
 
+/**
+ * verify that the cached whitelist and blacklist verdicts follow changes of the lists, including undone ones
+ */
+BOOST_AUTO_TEST_CASE( whitelist_verdict_cache_test )
+{
+   try {
+      INVOKE(issue_whitelist_uia);
+      const asset_object& advanced = get_asset("ADVANCED");
+      const account_object& nathan = get_account("nathan");
+      const account_object& dan = create_account("dan");
+      account_id_type izzy_id = get_account("izzy").id;
+
+      BOOST_CHECK( is_authorized_asset( db, nathan, advanced ) );
+      BOOST_CHECK( !is_authorized_asset( db, dan, advanced ) );
+      BOOST_CHECK_GE( db.get_asset_authorizations().size(), 2u );
+
+      BOOST_TEST_MESSAGE( "Whitelisting dan, then undoing it" );
+      {
+         auto session = db._undo_db.start_undo_session();
+         db.modify( dan, [izzy_id]( account_object& a ) { a.whitelisting_accounts.insert( izzy_id ); } );
+         BOOST_CHECK( is_authorized_asset( db, dan, advanced ) );
+         BOOST_CHECK( is_authorized_asset( db, nathan, advanced ) );
+      }
+      BOOST_CHECK( !is_authorized_asset( db, dan, advanced ) );
+
+      BOOST_TEST_MESSAGE( "Blacklisting nathan, then undoing it" );
+      {
+         auto session = db._undo_db.start_undo_session();
+         db.modify( advanced, [izzy_id]( asset_object& a ) { a.options.blacklist_authorities.insert( izzy_id ); } );
+         db.modify( nathan, [izzy_id]( account_object& a ) { a.blacklisting_accounts.insert( izzy_id ); } );
+         BOOST_CHECK( !is_authorized_asset( db, nathan, advanced ) );
+      }
+      BOOST_CHECK( is_authorized_asset( db, nathan, advanced ) );
+
+      BOOST_TEST_MESSAGE( "Dropping the whitelist authorities, then undoing it" );
+      {
+         auto session = db._undo_db.start_undo_session();
+         db.modify( advanced, []( asset_object& a ) { a.options.whitelist_authorities.clear(); } );
+         BOOST_CHECK( is_authorized_asset( db, dan, advanced ) );
+      }
+      BOOST_CHECK( !is_authorized_asset( db, dan, advanced ) );
+      BOOST_CHECK( is_authorized_asset( db, nathan, advanced ) );
+   } catch(fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 /**
  * verify that issuers can halt transfers
  */